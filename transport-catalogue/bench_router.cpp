@@ -0,0 +1,517 @@
+#include "graph.h"
+#include "router.h"
+#include "dijkstra_router.h"
+#include "fixed_point.h"
+#include "landmarks.h"
+#include "thread_pool.h"
+#include "city_generator.h"
+#include "json_reader.h"
+#include "transport_router.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace std::literals;
+
+namespace bench {
+
+using Clock = std::chrono::steady_clock;
+
+// Текущий размер резидентной памяти процесса в килобайтах (0, если /proc недоступен)
+size_t GetResidentMemoryKb() {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.rfind("VmRSS:", 0) == 0) {
+            return std::stoul(line.substr(line.find_first_of("0123456789")));
+        }
+    }
+    return 0;
+}
+
+// Решётка side x side с рёбрами в обе стороны между соседями и случайными весами
+std::unique_ptr<graph::DirectedWeightedGraph<double>> MakeGridGraph(size_t side, std::mt19937& generator) {
+    auto result = std::make_unique<graph::DirectedWeightedGraph<double>>(side * side);
+    std::uniform_real_distribution<double> weight_distribution(1.0, 10.0);
+
+    for (size_t row = 0; row < side; ++row) {
+        for (size_t column = 0; column < side; ++column) {
+            const graph::VertexId vertex = row * side + column;
+            if (column + 1 < side) {
+                result->AddEdge({vertex, vertex + 1, weight_distribution(generator)});
+                result->AddEdge({vertex + 1, vertex, weight_distribution(generator)});
+            }
+            if (row + 1 < side) {
+                result->AddEdge({vertex, vertex + side, weight_distribution(generator)});
+                result->AddEdge({vertex + side, vertex, weight_distribution(generator)});
+            }
+        }
+    }
+    return result;
+}
+
+template <typename Router>
+double MeasureQueries(const Router& router, const std::vector<std::pair<graph::VertexId, graph::VertexId>>& queries,
+                      double& checksum) {
+    const auto start = Clock::now();
+    for (const auto& [from, to] : queries) {
+        if (const auto route = router.BuildRoute(from, to)) {
+            checksum += route->weight;
+        }
+    }
+    const std::chrono::duration<double, std::micro> elapsed = Clock::now() - start;
+    return elapsed.count() / queries.size();
+}
+
+void BenchmarkCsrGraph(size_t side, size_t query_count) {
+    std::mt19937 generator(42);
+
+    const size_t memory_before_graph = GetResidentMemoryKb();
+    const auto graph = MakeGridGraph(side, generator);
+    const size_t memory_after_graph = GetResidentMemoryKb();
+    const graph::CsrGraph<double> csr_graph(*graph);
+    const size_t memory_after_csr = GetResidentMemoryKb();
+
+    std::uniform_int_distribution<graph::VertexId> vertex_distribution(0, graph->GetVertexCount() - 1);
+    std::vector<std::pair<graph::VertexId, graph::VertexId>> queries(query_count);
+    for (auto& [from, to] : queries) {
+        from = vertex_distribution(generator);
+        to = vertex_distribution(generator);
+    }
+
+    const graph::DijkstraRouter<double> list_router(*graph);
+    const graph::DijkstraRouter<double, graph::CsrGraph<double>> csr_router(csr_graph);
+
+    double list_checksum = 0;
+    double csr_checksum = 0;
+    const double list_time = MeasureQueries(list_router, queries, list_checksum);
+    const double csr_time = MeasureQueries(csr_router, queries, csr_checksum);
+
+    std::cout << "graph: "sv << graph->GetVertexCount() << " vertices, "sv << graph->GetEdgeCount() << " edges, "sv
+              << query_count << " queries\n"sv;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "incidence lists: "sv << std::setw(10) << list_time << " us/query, "sv
+              << memory_after_graph - memory_before_graph << " KiB RSS\n"sv;
+    std::cout << "csr:             "sv << std::setw(10) << csr_time << " us/query, "sv
+              << memory_after_csr - memory_after_graph << " KiB RSS\n"sv;
+    if (list_checksum != csr_checksum) {
+        std::cout << "WARNING: route weights differ\n"sv;
+    }
+}
+
+// Время предвычисления graph::Router при числе потоков 1, 2, 4, ... max_thread_count
+void BenchmarkAllPairsScaling(size_t side, size_t max_thread_count) {
+    std::mt19937 generator(42);
+    const auto graph = MakeGridGraph(side, generator);
+
+    const size_t cell_count = graph->GetVertexCount() * graph->GetVertexCount();
+    const size_t table_bytes = cell_count * (sizeof(double) + sizeof(uint32_t));
+
+    std::cout << "graph: "sv << graph->GetVertexCount() << " vertices, "sv << graph->GetEdgeCount() << " edges, "sv
+              << "route table "sv << table_bytes / 1024 << " KiB\n"sv;
+    std::cout << std::fixed << std::setprecision(3);
+
+    std::optional<double> single_thread_time;
+    std::optional<double> single_thread_checksum;
+    for (size_t thread_count = 1; thread_count <= max_thread_count; thread_count *= 2) {
+        const auto start = Clock::now();
+        const graph::Router<double> router(*graph, thread_count);
+        const std::chrono::duration<double> elapsed = Clock::now() - start;
+
+        double checksum = 0;
+        for (const double weight : router.GetRoutesInternalData().weights) {
+            checksum += weight != graph::Router<double>::NO_ROUTE_WEIGHT ? weight : 0;
+        }
+        if (!single_thread_time) {
+            single_thread_time = elapsed.count();
+            single_thread_checksum = checksum;
+        }
+
+        std::cout << std::setw(3) << thread_count << " threads: "sv << std::setw(10) << elapsed.count() << " s, speedup "sv
+                  << *single_thread_time / elapsed.count() << "\n"sv;
+        if (checksum != *single_thread_checksum) {
+            std::cout << "WARNING: route weights differ from the single-threaded run\n"sv;
+        }
+    }
+}
+
+// Число вершин, извлечённых из очереди, у Дейкстры, A* и ALT на одних и тех же запросах.
+// Вершины решётки стоят в узлах с шагом 1, веса рёбер не меньше 1, поэтому
+// евклидово расстояние - допустимая оценка для A*
+void BenchmarkGoalDirectedSearch(size_t side, size_t query_count) {
+    std::mt19937 generator(42);
+    const auto graph = MakeGridGraph(side, generator);
+    const graph::CsrGraph<double> csr_graph(*graph);
+
+    std::uniform_int_distribution<graph::VertexId> vertex_distribution(0, graph->GetVertexCount() - 1);
+    std::vector<std::pair<graph::VertexId, graph::VertexId>> queries(query_count);
+    for (auto& [from, to] : queries) {
+        from = vertex_distribution(generator);
+        to = vertex_distribution(generator);
+    }
+
+    const auto landmarks_start = Clock::now();
+    const graph::Landmarks<double> landmarks(*graph);
+    const std::chrono::duration<double> landmarks_time = Clock::now() - landmarks_start;
+
+    using Router = graph::DijkstraRouter<double, graph::CsrGraph<double>>;
+    const Router dijkstra_router(csr_graph);
+    const Router astar_router(csr_graph, [side](graph::VertexId vertex, graph::VertexId target) {
+        const double rows = static_cast<double>(vertex / side) - static_cast<double>(target / side);
+        const double columns = static_cast<double>(vertex % side) - static_cast<double>(target % side);
+        return std::sqrt(rows * rows + columns * columns);
+    });
+    const Router alt_router(csr_graph, [&landmarks](graph::VertexId vertex, graph::VertexId target) {
+        return landmarks.GetLowerBound(vertex, target);
+    });
+
+    std::cout << "graph: "sv << graph->GetVertexCount() << " vertices, "sv << graph->GetEdgeCount() << " edges, "sv
+              << query_count << " queries\n"sv;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "landmarks: "sv << landmarks.GetLandmarks().size() << " chosen in "sv
+              << landmarks_time.count() * 1000 << " ms\n"sv;
+
+    double dijkstra_checksum = 0;
+    double dijkstra_settled = 0;
+    const std::pair<std::string_view, const Router*> routers[] = {
+        {"dijkstra"sv, &dijkstra_router}, {"astar"sv, &astar_router}, {"alt"sv, &alt_router}};
+    for (const auto& [name, router] : routers) {
+        double checksum = 0;
+        const double time = MeasureQueries(*router, queries, checksum);
+        const auto statistics = router->GetStatistics();
+        const double settled = static_cast<double>(statistics.settled_vertex_count) / statistics.query_count;
+        if (router == &dijkstra_router) {
+            dijkstra_checksum = checksum;
+            dijkstra_settled = settled;
+        }
+
+        std::cout << std::setw(8) << name << ": "sv << std::setw(10) << time << " us/query, "sv
+                  << std::setw(10) << settled << " settled/query ("sv
+                  << settled * 100 / dijkstra_settled
+                  << "% of dijkstra)\n"sv;
+        if (std::abs(checksum - dijkstra_checksum) > 1e-6 * dijkstra_checksum) {
+            std::cout << "WARNING: route weights differ from dijkstra\n"sv;
+        }
+    }
+}
+
+// Пропускная способность пакета независимых запросов Дейкстры при числе потоков 1, 2, 4, ... max_thread_count:
+// запросы раздаются пулом потоков, у каждого потока свои рабочие массивы поиска
+void BenchmarkParallelQueries(size_t side, size_t query_count, size_t max_thread_count) {
+    std::mt19937 generator(42);
+    const auto graph = MakeGridGraph(side, generator);
+    const graph::CsrGraph<double> csr_graph(*graph);
+    const graph::DijkstraRouter<double, graph::CsrGraph<double>> router(csr_graph);
+
+    std::uniform_int_distribution<graph::VertexId> vertex_distribution(0, graph->GetVertexCount() - 1);
+    std::vector<std::pair<graph::VertexId, graph::VertexId>> queries(query_count);
+    for (auto& [from, to] : queries) {
+        from = vertex_distribution(generator);
+        to = vertex_distribution(generator);
+    }
+
+    std::cout << "graph: "sv << graph->GetVertexCount() << " vertices, "sv << graph->GetEdgeCount() << " edges, "sv
+              << query_count << " queries\n"sv;
+    std::cout << std::fixed << std::setprecision(1);
+
+    std::optional<double> single_thread_throughput;
+    std::optional<double> single_thread_checksum;
+    for (size_t thread_count = 1; thread_count <= max_thread_count; thread_count *= 2) {
+        std::vector<double> weights(queries.size(), 0);
+
+        const auto start = Clock::now();
+        concurrency::ThreadPool thread_pool(thread_count);
+        thread_pool.ParallelFor(queries.size(), [&](size_t index) {
+            const auto route = router.BuildRoute(queries[index].first, queries[index].second);
+            weights[index] = route ? route->weight : 0;
+        });
+        const std::chrono::duration<double> elapsed = Clock::now() - start;
+
+        double checksum = 0;
+        for (const double weight : weights) {
+            checksum += weight;
+        }
+        const double throughput = queries.size() / elapsed.count();
+        if (!single_thread_throughput) {
+            single_thread_throughput = throughput;
+            single_thread_checksum = checksum;
+        }
+
+        std::cout << std::setw(3) << thread_count << " threads: "sv << std::setw(10) << throughput << " queries/s, speedup "sv
+                  << std::setprecision(2) << throughput / *single_thread_throughput << std::setprecision(1) << "\n"sv;
+        if (checksum != *single_thread_checksum) {
+            std::cout << "WARNING: route weights differ from the single-threaded run\n"sv;
+        }
+    }
+}
+
+// Дейкстра по весам double с двоичной кучей против Дейкстры по целым весам (тысячные доли
+// веса решётки) с RadixHeap на одних и тех же запросах. Веса маршрутов у целочисленного
+// роутера складываются из весов double, поэтому совпадают, если совпал сам маршрут
+void BenchmarkFixedPointWeights(size_t side, size_t query_count) {
+    std::mt19937 generator(42);
+    const auto graph = MakeGridGraph(side, generator);
+
+    std::uniform_int_distribution<graph::VertexId> vertex_distribution(0, graph->GetVertexCount() - 1);
+    std::vector<std::pair<graph::VertexId, graph::VertexId>> queries(query_count);
+    for (auto& [from, to] : queries) {
+        from = vertex_distribution(generator);
+        to = vertex_distribution(generator);
+    }
+
+    const graph::CsrGraph<double> csr_graph(*graph);
+    const graph::FixedPointRouter<uint32_t> fixed_point_router(*graph, 1000);
+    const graph::DijkstraRouter<double, graph::CsrGraph<double>> double_router(csr_graph);
+
+    double double_checksum = 0;
+    double fixed_point_checksum = 0;
+    const double double_time = MeasureQueries(double_router, queries, double_checksum);
+    const double fixed_point_time = MeasureQueries(fixed_point_router, queries, fixed_point_checksum);
+
+    size_t different_route_count = 0;
+    for (const auto& [from, to] : queries) {
+        const auto double_route = double_router.BuildRoute(from, to);
+        const auto fixed_point_route = fixed_point_router.BuildRoute(from, to);
+        if (double_route && fixed_point_route && double_route->edges != fixed_point_route->edges) {
+            ++different_route_count;
+        }
+    }
+
+    std::cout << "graph: "sv << graph->GetVertexCount() << " vertices, "sv << graph->GetEdgeCount() << " edges, "sv
+              << query_count << " queries\n"sv;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "double, binary heap:  "sv << std::setw(10) << double_time << " us/query\n"sv;
+    std::cout << "uint32_t, radix heap: "sv << std::setw(10) << fixed_point_time << " us/query\n"sv;
+    std::cout << "routes that differ: "sv << different_route_count << "\n"sv;
+    if (std::abs(fixed_point_checksum - double_checksum) > 1e-6 * double_checksum) {
+        std::cout << "WARNING: route weights differ\n"sv;
+    }
+}
+
+// Доля share отсортированных значений не больше результата
+double GetPercentile(const std::vector<double>& sorted_values, double share) {
+    const size_t index = static_cast<size_t>(std::ceil(share * sorted_values.size()));
+    return sorted_values[std::clamp<size_t>(index, 1, sorted_values.size()) - 1];
+}
+
+// TransportRouter на синтетическом городе: заполнение справочника, построение графа,
+// предвычисления выбранного движка, память и задержки отдельных запросов маршрута.
+// Граф строится роутером с Дейкстрой, которому предвычисления не нужны, затем движок
+// строится по копии готового графа - так же, как при чтении базы без движка
+void BenchmarkTransportRouter(const transport_catalogue::generator::CitySettings& city_settings,
+                              transport_catalogue::router::RouterType router_type,
+                              transport_catalogue::router::GraphModel graph_model,
+                              size_t query_count) {
+    using namespace transport_catalogue;
+
+    json::Document make_base = generator::GenerateMakeBase(city_settings, "transport_catalogue.db"s);
+
+    TransportCatalogue catalogue;
+    renderer::RenderSettings render_settings;
+    router::RoutingSettings routing_settings;
+    serialization::SerializationSettings serialization_settings;
+
+    const size_t memory_before_catalogue = GetResidentMemoryKb();
+    const auto catalogue_start = Clock::now();
+    handling_json::SplittingDocumentMakeBase(make_base, render_settings, routing_settings, catalogue, serialization_settings);
+    const std::chrono::duration<double, std::milli> catalogue_time = Clock::now() - catalogue_start;
+    const size_t memory_after_catalogue = GetResidentMemoryKb();
+
+    routing_settings.router_type = router_type;
+    routing_settings.graph_model = graph_model;
+
+    std::cout << "city: "sv << catalogue.GetStops().size() << " stops, "sv << catalogue.GetBuses().size() << " buses\n"sv;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "catalogue:  "sv << std::setw(10) << catalogue_time.count() << " ms, "sv
+              << memory_after_catalogue - memory_before_catalogue << " KiB RSS\n"sv;
+
+    std::unique_ptr<router::TransportRouter> transport_router;
+    if (router_type != router::RouterType::RAPTOR) {
+        router::RoutingSettings graph_settings = routing_settings;
+        graph_settings.router_type = router::RouterType::DIJKSTRA;
+
+        const size_t memory_before_graph = GetResidentMemoryKb();
+        const auto graph_start = Clock::now();
+        auto graph_router = std::make_unique<router::TransportRouter>(catalogue, graph_settings);
+        const std::chrono::duration<double, std::milli> graph_time = Clock::now() - graph_start;
+        const size_t memory_after_graph = GetResidentMemoryKb();
+
+        std::cout << "graph:      "sv << std::setw(10) << graph_time.count() << " ms, "sv
+                  << memory_after_graph - memory_before_graph << " KiB RSS, "sv
+                  << graph_router->GetGraph().GetVertexCount() << " vertices, "sv
+                  << graph_router->GetGraph().GetEdgeCount() << " edges\n"sv;
+
+        auto graph = std::make_unique<graph::DirectedWeightedGraph<double>>(graph_router->GetGraph());
+        std::vector<router::EdgeData> edges = graph_router->GetEdges();
+        std::vector<router::BusWaitingPeriod> bus_waiting_periods = graph_router->GetBusWaitingPeriods();
+        graph_router.reset();
+
+        const size_t memory_before_router = GetResidentMemoryKb();
+        const auto router_start = Clock::now();
+        transport_router = std::make_unique<router::TransportRouter>(catalogue, routing_settings, std::move(graph), nullptr,
+                                                                     std::move(edges), std::move(bus_waiting_periods));
+        const std::chrono::duration<double, std::milli> router_time = Clock::now() - router_start;
+        const size_t memory_after_router = GetResidentMemoryKb();
+
+        std::cout << "precompute: "sv << std::setw(10) << router_time.count() << " ms, "sv
+                  << memory_after_router - memory_before_router << " KiB RSS\n"sv;
+        if (const auto* hub_labels = dynamic_cast<const graph::HubLabels<double>*>(&transport_router->GetRouter())) {
+            const double vertex_count = static_cast<double>(transport_router->GetGraph().GetVertexCount());
+            std::cout << "hub labels: "sv << hub_labels->GetOutLabels().hubs.size() / vertex_count << " out, "sv
+                      << hub_labels->GetInLabels().hubs.size() / vertex_count << " in hubs per vertex\n"sv;
+        }
+    } else {
+        const size_t memory_before_router = GetResidentMemoryKb();
+        const auto router_start = Clock::now();
+        transport_router = std::make_unique<router::TransportRouter>(catalogue, routing_settings);
+        const std::chrono::duration<double, std::milli> router_time = Clock::now() - router_start;
+        const size_t memory_after_router = GetResidentMemoryKb();
+
+        std::cout << "precompute: "sv << std::setw(10) << router_time.count() << " ms, "sv
+                  << memory_after_router - memory_before_router << " KiB RSS (no graph)\n"sv;
+    }
+
+    std::vector<const Stop*> stops;
+    for (const Stop& stop : catalogue.GetStops()) {
+        stops.push_back(&stop);
+    }
+
+    std::mt19937 generator(city_settings.seed);
+    std::uniform_int_distribution<size_t> stop_distribution(0, stops.size() - 1);
+    std::vector<std::pair<const Stop*, const Stop*>> queries(query_count);
+    for (auto& [from, to] : queries) {
+        from = stops[stop_distribution(generator)];
+        to = stops[stop_distribution(generator)];
+    }
+
+    std::vector<double> latencies;
+    latencies.reserve(queries.size());
+    size_t found_count = 0;
+    for (const auto& [from, to] : queries) {
+        const auto start = Clock::now();
+        const auto route = transport_router->GetRouteInformation(from, to);
+        const std::chrono::duration<double, std::micro> elapsed = Clock::now() - start;
+        latencies.push_back(elapsed.count());
+        found_count += route ? 1 : 0;
+    }
+    std::sort(latencies.begin(), latencies.end());
+
+    std::cout << "queries:    "sv << queries.size() << ", "sv << found_count << " routes found\n"sv;
+    std::cout << "latency us: p50 "sv << GetPercentile(latencies, 0.5) << ", p90 "sv << GetPercentile(latencies, 0.9)
+              << ", p99 "sv << GetPercentile(latencies, 0.99) << ", max "sv << latencies.back() << "\n"sv;
+
+    // повторяющиеся запросы: частые пары спрашивают намного чаще редких
+    if (routing_settings.route_cache_capacity > 0) {
+        std::uniform_real_distribution<double> share_distribution(0, 1);
+        const auto start = Clock::now();
+        for (size_t query = 0; query < queries.size(); ++query) {
+            const double share = share_distribution(generator);
+            const auto& [from, to] = queries[static_cast<size_t>(share * share * share * queries.size())];
+            transport_router->GetCachedRoute(from, to, [](const router::RouteData&) {
+                return json::Node{};
+            });
+        }
+        const std::chrono::duration<double, std::micro> elapsed = Clock::now() - start;
+        const auto statistics = transport_router->GetRouteCacheStatistics();
+
+        std::cout << "cache:      "sv << std::setw(10) << elapsed.count() / queries.size() << " us/query, "sv
+                  << statistics.hit_count << " hits, "sv << statistics.miss_count << " misses, "sv
+                  << statistics.eviction_count << " evictions\n"sv;
+    }
+}
+
+}  // namespace bench
+
+void PrintUsage(std::ostream& stream = std::cerr) {
+    stream << "Usage: bench_router csr [grid_side] [query_count]\n"sv
+           << "       bench_router all_pairs [grid_side] [max_thread_count]\n"sv
+           << "       bench_router astar [grid_side] [query_count]\n"sv
+           << "       bench_router parallel [grid_side] [query_count] [max_thread_count]\n"sv
+           << "       bench_router fixed_point [grid_side] [query_count]\n"sv
+           << "       bench_router generate [grid|radial|city] [stop_count] [bus_count] [stops_per_bus] [seed]\n"sv
+           << "       bench_router transport [grid|radial|city] [stop_count] [bus_count] [stops_per_bus]\n"sv
+           << "                              [router_type] [graph_model] [query_count]\n"sv;
+}
+
+// Настройки города из аргументов argv[first_argument] и дальше: расположение, число остановок,
+// автобусов и остановок на автобус
+transport_catalogue::generator::CitySettings ParsingCitySettings(int argc, char* argv[], int first_argument) {
+    transport_catalogue::generator::CitySettings result;
+    if (argc > first_argument) {
+        result.layout = transport_catalogue::generator::ParsingCityLayout(argv[first_argument]);
+    }
+    if (argc > first_argument + 1) {
+        result.stop_count = std::stoul(argv[first_argument + 1]);
+    }
+    if (argc > first_argument + 2) {
+        result.bus_count = std::stoul(argv[first_argument + 2]);
+    }
+    if (argc > first_argument + 3) {
+        result.stops_per_bus = std::stoul(argv[first_argument + 3]);
+    }
+    return result;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2 || argc > 9) {
+        PrintUsage();
+        return 1;
+    }
+
+    const std::string_view mode(argv[1]);
+
+    if (mode == "csr"sv) {
+        const size_t side = argc > 2 ? std::stoul(argv[2]) : 300;
+        const size_t query_count = argc > 3 ? std::stoul(argv[3]) : 200;
+        bench::BenchmarkCsrGraph(side, query_count);
+    } else if (mode == "all_pairs"sv) {
+        const size_t side = argc > 2 ? std::stoul(argv[2]) : 30;
+        const size_t max_thread_count = argc > 3 ? std::stoul(argv[3]) : std::thread::hardware_concurrency();
+        bench::BenchmarkAllPairsScaling(side, std::max<size_t>(max_thread_count, 1));
+    } else if (mode == "astar"sv) {
+        const size_t side = argc > 2 ? std::stoul(argv[2]) : 300;
+        const size_t query_count = argc > 3 ? std::stoul(argv[3]) : 200;
+        bench::BenchmarkGoalDirectedSearch(side, query_count);
+    } else if (mode == "parallel"sv) {
+        const size_t side = argc > 2 ? std::stoul(argv[2]) : 300;
+        const size_t query_count = argc > 3 ? std::stoul(argv[3]) : 2000;
+        const size_t max_thread_count = argc > 4 ? std::stoul(argv[4]) : 64;
+        bench::BenchmarkParallelQueries(side, query_count, std::max<size_t>(max_thread_count, 1));
+    } else if (mode == "fixed_point"sv) {
+        const size_t side = argc > 2 ? std::stoul(argv[2]) : 300;
+        const size_t query_count = argc > 3 ? std::stoul(argv[3]) : 200;
+        bench::BenchmarkFixedPointWeights(side, query_count);
+    } else if (mode == "generate"sv) {
+        auto city_settings = ParsingCitySettings(argc, argv, 2);
+        if (argc > 6) {
+            city_settings.seed = std::stoul(argv[6]);
+        }
+        json::Print(transport_catalogue::generator::GenerateMakeBase(city_settings, "transport_catalogue.db"s), std::cout);
+    } else if (mode == "transport"sv) {
+        namespace reader = transport_catalogue::handling_json::reader;
+        const auto city_settings = ParsingCitySettings(argc, argv, 2);
+        const auto router_type = argc > 6 ? reader::ParsingRouterType(json::Node(std::string(argv[6])))
+                                          : transport_catalogue::router::RouterType::DIJKSTRA;
+        const auto graph_model = argc > 7 ? reader::ParsingGraphModel(json::Node(std::string(argv[7])))
+                                          : transport_catalogue::router::GraphModel::COMPLETE;
+        const size_t query_count = argc > 8 ? std::stoul(argv[8]) : 1000;
+        bench::BenchmarkTransportRouter(city_settings, router_type, graph_model, std::max<size_t>(query_count, 1));
+    } else {
+        PrintUsage();
+        return 1;
+    }
+}
@@ -0,0 +1,474 @@
+#include "city_generator.h"
+
+#include "geo.h"
+#include "json_builder.h"
+
+#include <algorithm>
+#include <cmath>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace transport_catalogue {
+namespace generator {
+
+namespace {
+
+const double METERS_PER_DEGREE = 111195; // длина градуса меридиана
+const double STOP_SPACING = 400;         // метров между соседними остановками
+const double PI = 3.14159265358979323846;
+const geo::Coordinates CITY_CENTER = {55.75, 37.62};
+
+// Положение остановки на плоскости: метры к северу и к востоку от центра города
+struct Point {
+    double north = 0;
+    double east = 0;
+};
+
+double ComputePlaneDistance(Point from, Point to) {
+    return std::hypot(from.north - to.north, from.east - to.east);
+}
+
+geo::Coordinates ToCoordinates(Point point) {
+    return {CITY_CENTER.lat + point.north / METERS_PER_DEGREE,
+            CITY_CENTER.lng + point.east / (METERS_PER_DEGREE * std::cos(CITY_CENTER.lat * PI / 180))};
+}
+
+// Последовательность остановок автобуса; у кольцевого первая остановка повторяется в конце
+struct Line {
+    std::vector<size_t> stops;
+    bool is_roundtrip = false;
+};
+
+// Ближайшая к точке остановка по ячейкам со стороной STOP_SPACING
+class StopIndex {
+public:
+    explicit StopIndex(const std::vector<Point>& points)
+    : points_(points)
+    {
+        for (size_t stop = 0; stop < points_.size(); ++stop) {
+            const auto [row, column] = GetCell(points_[stop]);
+            cells_[GetKey(row, column)].push_back(stop);
+            max_ring_ = std::max({max_ring_, std::abs(row), std::abs(column)});
+        }
+    }
+
+    // Остановки из excluded пропускаются; nullopt, если подходящих нет
+    std::optional<size_t> FindNearest(Point point, const std::unordered_set<size_t>& excluded) const {
+        const auto [center_row, center_column] = GetCell(point);
+        std::optional<size_t> result;
+        double best_distance = 0;
+
+        const int64_t last_ring = max_ring_ + std::max(std::abs(center_row), std::abs(center_column));
+        for (int64_t ring = 0; ring <= last_ring; ++ring) {
+            for (int64_t row = center_row - ring; row <= center_row + ring; ++row) {
+                // внутренние ячейки кольца уже просмотрены
+                const int64_t step = (row == center_row - ring || row == center_row + ring) ? 1 : 2 * ring;
+                for (int64_t column = center_column - ring; column <= center_column + ring; column += std::max<int64_t>(step, 1)) {
+                    const auto it = cells_.find(GetKey(row, column));
+                    if (it == cells_.end()) {
+                        continue;
+                    }
+                    for (const size_t stop : it->second) {
+                        const double distance = ComputePlaneDistance(point, points_[stop]);
+                        if (excluded.count(stop) == 0 && (!result || distance < best_distance)) {
+                            result = stop;
+                            best_distance = distance;
+                        }
+                    }
+                }
+            }
+            // остановки следующих колец не ближе ring * STOP_SPACING
+            if (result && best_distance <= ring * STOP_SPACING) {
+                break;
+            }
+        }
+
+        return result;
+    }
+
+private:
+    static std::pair<int64_t, int64_t> GetCell(Point point) {
+        return {static_cast<int64_t>(std::floor(point.north / STOP_SPACING)),
+                static_cast<int64_t>(std::floor(point.east / STOP_SPACING))};
+    }
+
+    static int64_t GetKey(int64_t row, int64_t column) {
+        return row * (int64_t{1} << 32) + column;
+    }
+
+    const std::vector<Point>& points_;
+    std::unordered_map<int64_t, std::vector<size_t>> cells_;
+    int64_t max_ring_ = 0;
+};
+
+class CityBuilder {
+public:
+    explicit CityBuilder(const CitySettings& settings)
+    : settings_(settings)
+    , generator_(settings.seed)
+    {
+    }
+
+    json::Array Build() {
+        switch (settings_.layout) {
+            case CityLayout::GRID:
+                PlaceGrid();
+                break;
+            case CityLayout::RADIAL:
+                PlaceRadial();
+                break;
+            case CityLayout::CITY:
+                PlaceCity();
+                break;
+        }
+
+        road_distances_.assign(points_.size(), json::Dict{});
+
+        json::Array buses;
+        for (size_t bus = 0; bus < settings_.bus_count; ++bus) {
+            Line line;
+            switch (settings_.layout) {
+                case CityLayout::GRID:
+                    line = MakeGridLine();
+                    break;
+                case CityLayout::RADIAL:
+                    line = MakeRadialLine();
+                    break;
+                case CityLayout::CITY:
+                    line = MakeCityLine();
+                    break;
+            }
+            AddRoadDistances(line);
+            buses.push_back(MakeBusRequest(bus, line));
+        }
+
+        json::Array result;
+        result.reserve(points_.size() + buses.size());
+        for (size_t stop = 0; stop < points_.size(); ++stop) {
+            const geo::Coordinates coordinates = ToCoordinates(points_[stop]);
+            result.push_back(json::Builder{}.StartDict()
+                                                .Key("type").Value(std::string("Stop"))
+                                                .Key("name").Value(GetStopName(stop))
+                                                .Key("latitude").Value(coordinates.lat)
+                                                .Key("longitude").Value(coordinates.lng)
+                                                .Key("road_distances").Value(std::move(road_distances_[stop]))
+                                            .EndDict()
+                                            .Build());
+        }
+        for (json::Node& bus : buses) {
+            result.push_back(std::move(bus));
+        }
+
+        return result;
+    }
+
+private:
+    static std::string GetStopName(size_t stop) {
+        return "Stop " + std::to_string(stop + 1);
+    }
+
+    size_t GetRandom(size_t bound) {
+        return std::uniform_int_distribution<size_t>(0, bound - 1)(generator_);
+    }
+
+    bool GetChance(double probability) {
+        return std::bernoulli_distribution(probability)(generator_);
+    }
+
+    // Случайный отрезок последовательности длиной не больше stops_per_bus
+    std::vector<size_t> TakeWindow(const std::vector<size_t>& stops) {
+        const size_t length = std::min(settings_.stops_per_bus, stops.size());
+        const size_t first = GetRandom(stops.size() - length + 1);
+        return {stops.begin() + first, stops.begin() + first + length};
+    }
+
+    //-------------------GRID--------------------
+
+    void PlaceGrid() {
+        side_ = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(settings_.stop_count))));
+        for (size_t stop = 0; stop < settings_.stop_count; ++stop) {
+            points_.push_back({(stop / side_) * STOP_SPACING, (stop % side_) * STOP_SPACING});
+        }
+    }
+
+    Line MakeGridLine() {
+        // последний ряд решётки может быть неполным
+        const size_t full_rows = settings_.stop_count / side_;
+
+        if (GetChance(0.25)) {
+            if (std::optional<Line> loop = MakeGridLoop(full_rows)) {
+                return *loop;
+            }
+        }
+
+        std::vector<size_t> street;
+        if (full_rows >= 2 && GetChance(0.5)) {
+            const size_t column = GetRandom(side_);
+            for (size_t row = 0; row < full_rows; ++row) {
+                street.push_back(row * side_ + column);
+            }
+        } else {
+            const size_t row = GetRandom(full_rows);
+            for (size_t column = 0; column < side_; ++column) {
+                street.push_back(row * side_ + column);
+            }
+        }
+
+        return Line{TakeWindow(street), false};
+    }
+
+    // Кольцо вокруг прямоугольника кварталов с периметром около stops_per_bus
+    std::optional<Line> MakeGridLoop(size_t full_rows) {
+        const size_t half_perimeter = settings_.stops_per_bus / 2;
+        if (half_perimeter < 2 || full_rows < 2 || side_ < 2) {
+            return std::nullopt;
+        }
+
+        const size_t height = std::clamp<size_t>(1 + GetRandom(half_perimeter - 1), 1, full_rows - 1);
+        const size_t width = std::clamp<size_t>(half_perimeter - height, 1, side_ - 1);
+        const size_t top = GetRandom(full_rows - height);
+        const size_t left = GetRandom(side_ - width);
+
+        Line result;
+        result.is_roundtrip = true;
+        for (size_t column = left; column < left + width; ++column) {
+            result.stops.push_back(top * side_ + column);
+        }
+        for (size_t row = top; row < top + height; ++row) {
+            result.stops.push_back(row * side_ + left + width);
+        }
+        for (size_t column = left + width; column > left; --column) {
+            result.stops.push_back((top + height) * side_ + column);
+        }
+        for (size_t row = top + height; row > top; --row) {
+            result.stops.push_back(row * side_ + left);
+        }
+        result.stops.push_back(result.stops.front());
+
+        return result;
+    }
+
+    //-------------------RADIAL--------------------
+
+    // Остановка 0 в центре, затем кольца по side_ лучей: на кольце ring луч spoke - остановка 1 + (ring - 1) * side_ + spoke
+    void PlaceRadial() {
+        side_ = std::max<size_t>(4, static_cast<size_t>(std::round(std::sqrt(static_cast<double>(settings_.stop_count)))));
+        points_.push_back({0, 0});
+        for (size_t stop = 1; stop < settings_.stop_count; ++stop) {
+            const size_t ring = (stop - 1) / side_ + 1;
+            const double angle = 2 * PI * ((stop - 1) % side_) / side_;
+            points_.push_back({ring * STOP_SPACING * std::sin(angle), ring * STOP_SPACING * std::cos(angle)});
+        }
+    }
+
+    Line MakeRadialLine() {
+        const size_t full_rings = (settings_.stop_count - 1) / side_;
+
+        if (full_rings > 0 && GetChance(0.5)) {
+            const size_t ring = 1 + GetRandom(full_rings);
+            const size_t first_spoke = GetRandom(side_);
+
+            std::vector<size_t> arc;
+            for (size_t step = 0; step < side_; ++step) {
+                arc.push_back(1 + (ring - 1) * side_ + (first_spoke + step) % side_);
+            }
+            if (side_ < settings_.stops_per_bus) {
+                arc.push_back(arc.front());
+                return Line{std::move(arc), true};
+            }
+            return Line{TakeWindow(arc), false};
+        }
+
+        // по лучу к центру и дальше по противоположному лучу
+        const size_t spoke = GetRandom(side_);
+        const size_t opposite_spoke = (spoke + side_ / 2) % side_;
+        std::vector<size_t> diameter;
+        for (size_t stop = spoke + 1; stop < settings_.stop_count; stop += side_) {
+            diameter.push_back(stop);
+        }
+        std::reverse(diameter.begin(), diameter.end());
+        diameter.push_back(0);
+        for (size_t stop = opposite_spoke + 1; stop < settings_.stop_count; stop += side_) {
+            diameter.push_back(stop);
+        }
+        if (diameter.size() < 2) {
+            diameter = {0, 1};
+        }
+
+        return Line{TakeWindow(diameter), false};
+    }
+
+    //-------------------CITY--------------------
+
+    // Районы вокруг случайных центров, ближе к центру города остановки гуще
+    void PlaceCity() {
+        const double city_radius = STOP_SPACING * std::sqrt(static_cast<double>(settings_.stop_count)) / 2;
+        const size_t district_count = std::max<size_t>(1, settings_.stop_count / 250);
+
+        std::uniform_real_distribution<double> unit_distribution(0, 1);
+        std::vector<Point> districts;
+        for (size_t district = 0; district < district_count; ++district) {
+            const double radius = city_radius * std::sqrt(unit_distribution(generator_));
+            const double angle = 2 * PI * unit_distribution(generator_);
+            districts.push_back({radius * std::sin(angle), radius * std::cos(angle)});
+        }
+
+        std::normal_distribution<double> offset_distribution(0, city_radius / std::sqrt(static_cast<double>(district_count)) / 2);
+        for (size_t stop = 0; stop < settings_.stop_count; ++stop) {
+            const Point& district = districts[GetRandom(district_count)];
+            points_.push_back({district.north + offset_distribution(generator_),
+                               district.east + offset_distribution(generator_)});
+        }
+
+        stop_index_.emplace(points_);
+    }
+
+    // Автобус идёт между двумя случайными остановками либо по кольцу вокруг одной из них,
+    // заходя на ближайшие к пути остановки
+    Line MakeCityLine() {
+        const size_t length = std::max<size_t>(settings_.stops_per_bus, 2);
+        const Point start = points_[GetRandom(points_.size())];
+        const bool is_roundtrip = length >= 4 && GetChance(0.3);
+
+        std::vector<Point> waypoints;
+        if (is_roundtrip) {
+            const double radius = length * STOP_SPACING / (2 * PI);
+            for (size_t step = 0; step < length; ++step) {
+                const double angle = 2 * PI * step / length;
+                waypoints.push_back({start.north + radius * std::sin(angle), start.east + radius * std::cos(angle)});
+            }
+        } else {
+            const Point finish = points_[GetRandom(points_.size())];
+            for (size_t step = 0; step < length; ++step) {
+                const double share = static_cast<double>(step) / (length - 1);
+                waypoints.push_back({start.north + (finish.north - start.north) * share,
+                                     start.east + (finish.east - start.east) * share});
+            }
+        }
+
+        Line result;
+        result.is_roundtrip = is_roundtrip;
+        std::unordered_set<size_t> visited;
+        for (const Point& waypoint : waypoints) {
+            if (const std::optional<size_t> stop = stop_index_->FindNearest(waypoint, visited)) {
+                result.stops.push_back(*stop);
+                visited.insert(*stop);
+            }
+        }
+
+        if (result.stops.size() < 2) {
+            result.stops = {0, 1};
+            result.is_roundtrip = false;
+        } else if (result.is_roundtrip) {
+            result.stops.push_back(result.stops.front());
+        }
+
+        return result;
+    }
+
+    //-------------------BUSES--------------------
+
+    // Дорога длиннее прямой на 10-40%; на части перегонов обратный путь другой длины
+    void AddRoadDistances(const Line& line) {
+        std::uniform_real_distribution<double> detour_distribution(1.1, 1.4);
+
+        for (size_t position = 1; position < line.stops.size(); ++position) {
+            const size_t from = line.stops[position - 1];
+            const size_t to = line.stops[position];
+            if (from == to) {
+                continue;
+            }
+
+            const double distance = geo::ComputeDistance(ToCoordinates(points_[from]), ToCoordinates(points_[to]));
+            road_distances_[from].emplace(GetStopName(to), static_cast<int>(distance * detour_distribution(generator_)) + 1);
+            if (GetChance(0.1)) {
+                road_distances_[to].emplace(GetStopName(from), static_cast<int>(distance * detour_distribution(generator_)) + 1);
+            }
+        }
+    }
+
+    json::Node MakeBusRequest(size_t bus, const Line& line) const {
+        json::Array stops;
+        stops.reserve(line.stops.size());
+        for (const size_t stop : line.stops) {
+            stops.push_back(GetStopName(stop));
+        }
+
+        return json::Builder{}.StartDict()
+                                  .Key("type").Value(std::string("Bus"))
+                                  .Key("name").Value("Bus " + std::to_string(bus + 1))
+                                  .Key("stops").Value(std::move(stops))
+                                  .Key("is_roundtrip").Value(line.is_roundtrip)
+                              .EndDict()
+                              .Build();
+    }
+
+    const CitySettings& settings_;
+    std::mt19937 generator_;
+
+    std::vector<Point> points_;
+    std::vector<json::Dict> road_distances_;
+    // GRID - ширина решётки, RADIAL - число лучей
+    size_t side_ = 0;
+    std::optional<StopIndex> stop_index_;
+};
+
+} //end namespace
+
+CityLayout ParsingCityLayout(std::string_view layout) {
+    if (layout == "grid") {
+        return CityLayout::GRID;
+    } else if (layout == "radial") {
+        return CityLayout::RADIAL;
+    } else if (layout == "city") {
+        return CityLayout::CITY;
+    }
+
+    throw std::invalid_argument("unknown city layout: " + std::string(layout));
+}
+
+json::Array GenerateBaseRequests(const CitySettings& settings) {
+    if (settings.stop_count < 2 || settings.stops_per_bus < 2) {
+        throw std::invalid_argument("a city needs at least 2 stops and 2 stops per bus");
+    }
+
+    return CityBuilder(settings).Build();
+}
+
+json::Document GenerateMakeBase(const CitySettings& settings, const std::string& file_name) {
+    return json::Document{json::Builder{}.StartDict()
+                                             .Key("serialization_settings").StartDict()
+                                                 .Key("file").Value(file_name)
+                                             .EndDict()
+                                             .Key("routing_settings").StartDict()
+                                                 .Key("bus_wait_time").Value(6)
+                                                 .Key("bus_velocity").Value(40)
+                                             .EndDict()
+                                             .Key("render_settings").StartDict()
+                                                 .Key("width").Value(1200.0)
+                                                 .Key("height").Value(1200.0)
+                                                 .Key("padding").Value(50.0)
+                                                 .Key("stop_radius").Value(3.0)
+                                                 .Key("line_width").Value(8.0)
+                                                 .Key("bus_label_font_size").Value(16)
+                                                 .Key("bus_label_offset").StartArray().Value(7.0).Value(15.0).EndArray()
+                                                 .Key("stop_label_font_size").Value(12)
+                                                 .Key("stop_label_offset").StartArray().Value(7.0).Value(-3.0).EndArray()
+                                                 .Key("underlayer_color").StartArray().Value(255).Value(255).Value(255).Value(0.85).EndArray()
+                                                 .Key("underlayer_width").Value(3.0)
+                                                 .Key("color_palette").StartArray().Value(std::string("green")).Value(std::string("red")).Value(std::string("blue"))
+                                                                                   .Value(std::string("orange")).Value(std::string("purple")).EndArray()
+                                             .EndDict()
+                                             .Key("base_requests").Value(GenerateBaseRequests(settings))
+                                         .EndDict()
+                                         .Build()};
+}
+
+} //end namespace generator
+} //end namespace transport_catalogue
@@ -0,0 +1,41 @@
+#pragma once
+
+/*
+ * Синтетические транспортные сети для замеров: генератор выдаёт запросы base_requests
+ * в том же формате, что и вход make_base
+ */
+
+#include "json.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace transport_catalogue {
+namespace generator {
+
+// Как расположены остановки и как по ним проходят автобусы
+enum class CityLayout {
+    GRID,   // остановки в узлах решётки, автобусы по улицам и вокруг кварталов
+    RADIAL, // кольца вокруг центра, автобусы по лучам через центр и по кольцам
+    CITY    // скопления остановок вокруг нескольких центров, автобусы между случайными районами
+};
+
+struct CitySettings {
+    CityLayout layout = CityLayout::GRID;
+    size_t stop_count = 1000;
+    size_t bus_count = 100;
+    // наибольшее число остановок в одном направлении автобуса
+    size_t stops_per_bus = 20;
+    uint32_t seed = 42;
+};
+
+CityLayout ParsingCityLayout(std::string_view layout);
+
+// Остановки с дорожными расстояниями и автобусы; одинаковые настройки дают одинаковую сеть
+json::Array GenerateBaseRequests(const CitySettings& settings);
+// Полный вход make_base: сеть, настройки маршрутов и отрисовки, файл базы file_name
+json::Document GenerateMakeBase(const CitySettings& settings, const std::string& file_name);
+
+} //end namespace generator
+} //end namespace transport_catalogue
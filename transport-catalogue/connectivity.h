@@ -0,0 +1,175 @@
+#pragma once
+
+#include "graph.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+// Компоненты связности графа: по ним часть пар вершин без пути отсеивается
+// двумя сравнениями, без поиска. Компоненты сильной связности пронумерованы
+// в топологическом порядке конденсации, поэтому путь из from в to возможен,
+// только если компоненты from не больше компоненты to и обе вершины лежат
+// в одной компоненте слабой связности
+class ConnectivityComponents {
+public:
+    template <typename Weight>
+    explicit ConnectivityComponents(const DirectedWeightedGraph<Weight>& graph);
+    // Восстанавливает ранее посчитанные компоненты
+    ConnectivityComponents(std::vector<uint32_t> strong_components, std::vector<uint32_t> weak_components);
+
+    // false - пути из from в to точно нет; true - путь возможен, и в одной компоненте
+    // сильной связности он точно есть
+    bool MayReach(VertexId from, VertexId to) const {
+        return weak_components_[from] == weak_components_[to]
+               && strong_components_[from] <= strong_components_[to];
+    }
+
+    const std::vector<uint32_t>& GetStrongComponents() const {
+        return strong_components_;
+    }
+
+    const std::vector<uint32_t>& GetWeakComponents() const {
+        return weak_components_;
+    }
+
+private:
+    template <typename Weight>
+    void ComputeStrongComponents(const DirectedWeightedGraph<Weight>& graph);
+    template <typename Weight>
+    void ComputeWeakComponents(const DirectedWeightedGraph<Weight>& graph);
+
+    std::vector<uint32_t> strong_components_;
+    std::vector<uint32_t> weak_components_;
+};
+
+template <typename Weight>
+ConnectivityComponents::ConnectivityComponents(const DirectedWeightedGraph<Weight>& graph) {
+    ComputeStrongComponents(graph);
+    ComputeWeakComponents(graph);
+}
+
+inline ConnectivityComponents::ConnectivityComponents(std::vector<uint32_t> strong_components,
+                                                      std::vector<uint32_t> weak_components)
+    : strong_components_(std::move(strong_components))
+    , weak_components_(std::move(weak_components))
+{
+    if (strong_components_.size() != weak_components_.size()) {
+        throw std::invalid_argument("Component arrays should have the same size");
+    }
+}
+
+// Тарьян без рекурсии: компонента закрывается после всех, в которые из неё есть рёбра,
+// поэтому номера закрытия идут в обратном топологическом порядке и в конце разворачиваются
+template <typename Weight>
+void ConnectivityComponents::ComputeStrongComponents(const DirectedWeightedGraph<Weight>& graph) {
+    static constexpr uint32_t NOT_VISITED = UINT32_MAX;
+    const size_t vertex_count = graph.GetVertexCount();
+
+    std::vector<uint32_t> indices(vertex_count, NOT_VISITED);
+    std::vector<uint32_t> low_links(vertex_count, 0);
+    std::vector<bool> on_stack(vertex_count, false);
+    std::vector<VertexId> stack;
+    // вершина обхода и номер её следующего ребра
+    std::vector<std::pair<VertexId, size_t>> call_stack;
+
+    strong_components_.assign(vertex_count, 0);
+    uint32_t next_index = 0;
+    uint32_t component_count = 0;
+
+    for (VertexId root = 0; root < vertex_count; ++root) {
+        if (indices[root] != NOT_VISITED) {
+            continue;
+        }
+        call_stack.emplace_back(root, 0);
+        indices[root] = low_links[root] = next_index++;
+        stack.push_back(root);
+        on_stack[root] = true;
+
+        while (!call_stack.empty()) {
+            auto& [vertex, edge_index] = call_stack.back();
+            const auto edges = graph.GetIncidentEdges(vertex);
+
+            if (edge_index < static_cast<size_t>(edges.end() - edges.begin())) {
+                const VertexId next = graph.GetEdge(*(edges.begin() + edge_index)).to;
+                ++edge_index;
+                if (indices[next] == NOT_VISITED) {
+                    indices[next] = low_links[next] = next_index++;
+                    stack.push_back(next);
+                    on_stack[next] = true;
+                    call_stack.emplace_back(next, 0);
+                } else if (on_stack[next]) {
+                    low_links[vertex] = std::min(low_links[vertex], indices[next]);
+                }
+                continue;
+            }
+
+            const VertexId finished = vertex;
+            call_stack.pop_back();
+            if (!call_stack.empty()) {
+                const VertexId parent = call_stack.back().first;
+                low_links[parent] = std::min(low_links[parent], low_links[finished]);
+            }
+            if (low_links[finished] == indices[finished]) {
+                VertexId member;
+                do {
+                    member = stack.back();
+                    stack.pop_back();
+                    on_stack[member] = false;
+                    strong_components_[member] = component_count;
+                } while (member != finished);
+                ++component_count;
+            }
+        }
+    }
+
+    for (uint32_t& component : strong_components_) {
+        component = component_count - 1 - component;
+    }
+}
+
+// Объединение множеств по рёбрам без учёта направления
+template <typename Weight>
+void ConnectivityComponents::ComputeWeakComponents(const DirectedWeightedGraph<Weight>& graph) {
+    const size_t vertex_count = graph.GetVertexCount();
+    std::vector<VertexId> parents(vertex_count);
+    std::iota(parents.begin(), parents.end(), 0);
+
+    auto find_root = [&parents](VertexId vertex) {
+        while (parents[vertex] != vertex) {
+            parents[vertex] = parents[parents[vertex]];
+            vertex = parents[vertex];
+        }
+        return vertex;
+    };
+
+    for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+        for (const EdgeId edge_id : graph.GetIncidentEdges(vertex)) {
+            const VertexId from_root = find_root(vertex);
+            const VertexId to_root = find_root(graph.GetEdge(edge_id).to);
+            if (from_root != to_root) {
+                parents[std::max(from_root, to_root)] = std::min(from_root, to_root);
+            }
+        }
+    }
+
+    // номер компоненты - в порядке первых вершин
+    static constexpr uint32_t NO_COMPONENT = UINT32_MAX;
+    std::vector<uint32_t> root_components(vertex_count, NO_COMPONENT);
+    uint32_t component_count = 0;
+    weak_components_.assign(vertex_count, 0);
+    for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+        const VertexId root = find_root(vertex);
+        if (root_components[root] == NO_COMPONENT) {
+            root_components[root] = component_count++;
+        }
+        weak_components_[vertex] = root_components[root];
+    }
+}
+
+}  // namespace graph
@@ -0,0 +1,485 @@
+#pragma once
+
+#include "router.h"
+#include "search_scratch.h"
+
+#include <algorithm>
+#include <functional>
+#include <optional>
+#include <queue>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+// Иерархия сжатия (contraction hierarchies): вершины сжимаются по порядку рангов,
+// недостающие кратчайшие пути заменяются шорткатами. Запрос - двунаправленный
+// поиск только вверх по рангам, найденные шорткаты раскрываются в исходные рёбра
+template <typename Weight>
+class ContractionHierarchy final : public RouterBase<Weight> {
+private:
+    using Graph = DirectedWeightedGraph<Weight>;
+
+public:
+    using RouteInfo = typename RouterBase<Weight>::RouteInfo;
+
+    // Рёбра иерархии с id < graph.GetEdgeCount() - исходные рёбра графа,
+    // id = graph.GetEdgeCount() + i - шорткат shortcuts[i]
+    struct Shortcut {
+        VertexId from;
+        VertexId to;
+        Weight weight;
+        EdgeId first_edge;
+        EdgeId second_edge;
+    };
+
+    explicit ContractionHierarchy(const Graph& graph);
+    // Восстанавливает иерархию по сохранённому порядку вершин и шорткатам
+    ContractionHierarchy(const Graph& graph, std::vector<size_t> ranks, std::vector<Shortcut> shortcuts);
+
+    std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to) const override;
+    // Поиск вверх от from выполняется один раз, для каждой цели - только обратный поиск
+    std::vector<std::optional<Weight>> BuildWeights(VertexId from, const std::vector<VertexId>& targets) const override;
+
+    const std::vector<size_t>& GetRanks() const {
+        return ranks_;
+    }
+    const std::vector<Shortcut>& GetShortcuts() const {
+        return shortcuts_;
+    }
+
+private:
+    using QueueItem = std::pair<Weight, VertexId>;
+    using Queue = std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>>;
+
+    // Число вершин, после которого поиск свидетеля сдаётся и шорткат добавляется без проверки
+    static constexpr size_t WITNESS_SETTLED_LIMIT = 50;
+
+    struct ContractionState {
+        std::vector<std::vector<EdgeId>> in_edges;
+        std::vector<std::vector<EdgeId>> out_edges;
+        std::vector<bool> contracted;
+        std::vector<int> contracted_neighbors;
+
+        std::vector<Weight> witness_weights;
+        std::vector<size_t> witness_marks;
+        size_t witness_mark = 0;
+    };
+
+    Edge<Weight> GetHierarchyEdge(EdgeId edge_id) const {
+        if (edge_id < graph_.GetEdgeCount()) {
+            return graph_.GetEdge(edge_id);
+        }
+        const Shortcut& shortcut = shortcuts_[edge_id - graph_.GetEdgeCount()];
+        return Edge<Weight>{shortcut.from, shortcut.to, shortcut.weight};
+    }
+
+    void RunWitnessSearch(ContractionState& state, VertexId source, VertexId excluded, Weight max_weight) const {
+        ++state.witness_mark;
+        Queue queue;
+        state.witness_weights[source] = ZERO_WEIGHT;
+        state.witness_marks[source] = state.witness_mark;
+        queue.push({ZERO_WEIGHT, source});
+
+        size_t settled = 0;
+        while (!queue.empty() && settled < WITNESS_SETTLED_LIMIT) {
+            const auto [weight, vertex] = queue.top();
+            queue.pop();
+            if (weight > state.witness_weights[vertex] || weight > max_weight) {
+                continue;
+            }
+            ++settled;
+            for (const EdgeId edge_id : state.out_edges[vertex]) {
+                const Edge<Weight> edge = GetHierarchyEdge(edge_id);
+                if (edge.to == excluded || state.contracted[edge.to]) {
+                    continue;
+                }
+                const Weight candidate_weight = weight + edge.weight;
+                if (state.witness_marks[edge.to] != state.witness_mark
+                    || candidate_weight < state.witness_weights[edge.to]) {
+                    state.witness_weights[edge.to] = candidate_weight;
+                    state.witness_marks[edge.to] = state.witness_mark;
+                    queue.push({candidate_weight, edge.to});
+                }
+            }
+        }
+    }
+
+    // Оставляет по одному самому лёгкому ребру к каждой несжатой соседней вершине
+    std::vector<EdgeId> GetLightestEdges(const ContractionState& state, const std::vector<EdgeId>& edges,
+                                         VertexId vertex, bool by_source) const {
+        std::vector<EdgeId> result;
+        for (const EdgeId edge_id : edges) {
+            const Edge<Weight> edge = GetHierarchyEdge(edge_id);
+            const VertexId neighbor = by_source ? edge.from : edge.to;
+            if (neighbor != vertex && !state.contracted[neighbor]) {
+                result.push_back(edge_id);
+            }
+        }
+        std::sort(result.begin(), result.end(), [this, by_source](EdgeId lhs, EdgeId rhs) {
+            const Edge<Weight> lhs_edge = GetHierarchyEdge(lhs);
+            const Edge<Weight> rhs_edge = GetHierarchyEdge(rhs);
+            const VertexId lhs_neighbor = by_source ? lhs_edge.from : lhs_edge.to;
+            const VertexId rhs_neighbor = by_source ? rhs_edge.from : rhs_edge.to;
+            return std::tie(lhs_neighbor, lhs_edge.weight) < std::tie(rhs_neighbor, rhs_edge.weight);
+        });
+        result.erase(std::unique(result.begin(), result.end(), [this, by_source](EdgeId lhs, EdgeId rhs) {
+            const Edge<Weight> lhs_edge = GetHierarchyEdge(lhs);
+            const Edge<Weight> rhs_edge = GetHierarchyEdge(rhs);
+            return (by_source ? lhs_edge.from == rhs_edge.from : lhs_edge.to == rhs_edge.to);
+        }), result.end());
+        return result;
+    }
+
+    // Возвращает шорткаты, необходимые при сжатии вершины vertex
+    std::vector<Shortcut> FindShortcuts(ContractionState& state, VertexId vertex) const {
+        std::vector<Shortcut> result;
+        const std::vector<EdgeId> in_edges = GetLightestEdges(state, state.in_edges[vertex], vertex, true);
+        const std::vector<EdgeId> out_edges = GetLightestEdges(state, state.out_edges[vertex], vertex, false);
+        if (out_edges.empty()) {
+            return result;
+        }
+
+        Weight max_out_weight = ZERO_WEIGHT;
+        for (const EdgeId edge_id : out_edges) {
+            max_out_weight = std::max(max_out_weight, GetHierarchyEdge(edge_id).weight);
+        }
+
+        for (const EdgeId in_edge_id : in_edges) {
+            const Edge<Weight> in_edge = GetHierarchyEdge(in_edge_id);
+            RunWitnessSearch(state, in_edge.from, vertex, in_edge.weight + max_out_weight);
+
+            for (const EdgeId out_edge_id : out_edges) {
+                const Edge<Weight> out_edge = GetHierarchyEdge(out_edge_id);
+                if (out_edge.to == in_edge.from) {
+                    continue;
+                }
+                const Weight candidate_weight = in_edge.weight + out_edge.weight;
+                if (state.witness_marks[out_edge.to] == state.witness_mark
+                    && !(candidate_weight < state.witness_weights[out_edge.to])) {
+                    continue;
+                }
+                result.push_back(Shortcut{in_edge.from, out_edge.to, candidate_weight, in_edge_id, out_edge_id});
+            }
+        }
+        return result;
+    }
+
+    int ComputePriority(ContractionState& state, VertexId vertex) const {
+        int degree = 0;
+        for (const EdgeId edge_id : state.in_edges[vertex]) {
+            degree += state.contracted[GetHierarchyEdge(edge_id).from] ? 0 : 1;
+        }
+        for (const EdgeId edge_id : state.out_edges[vertex]) {
+            degree += state.contracted[GetHierarchyEdge(edge_id).to] ? 0 : 1;
+        }
+        return static_cast<int>(FindShortcuts(state, vertex).size()) - degree + state.contracted_neighbors[vertex];
+    }
+
+    void Contract() {
+        const size_t vertex_count = graph_.GetVertexCount();
+        ContractionState state;
+        state.in_edges.resize(vertex_count);
+        state.out_edges.resize(vertex_count);
+        state.contracted.assign(vertex_count, false);
+        state.contracted_neighbors.assign(vertex_count, 0);
+        state.witness_weights.assign(vertex_count, ZERO_WEIGHT);
+        state.witness_marks.assign(vertex_count, 0);
+
+        for (EdgeId edge_id = 0; edge_id < graph_.GetEdgeCount(); ++edge_id) {
+            if (graph_.IsEdgeRemoved(edge_id)) {
+                continue;
+            }
+            const auto& edge = graph_.GetEdge(edge_id);
+            if (edge.weight < ZERO_WEIGHT) {
+                throw std::domain_error("Edges' weights should be non-negative");
+            }
+            state.out_edges[edge.from].push_back(edge_id);
+            state.in_edges[edge.to].push_back(edge_id);
+        }
+
+        using PriorityItem = std::pair<int, VertexId>;
+        std::priority_queue<PriorityItem, std::vector<PriorityItem>, std::greater<PriorityItem>> queue;
+        for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+            queue.push({ComputePriority(state, vertex), vertex});
+        }
+
+        size_t rank = 0;
+        while (!queue.empty()) {
+            const VertexId vertex = queue.top().second;
+            queue.pop();
+            if (state.contracted[vertex]) {
+                continue;
+            }
+            // Ленивое обновление: приоритет мог вырасти после сжатия соседей
+            const int priority = ComputePriority(state, vertex);
+            if (!queue.empty() && priority > queue.top().first) {
+                queue.push({priority, vertex});
+                continue;
+            }
+
+            for (const Shortcut& shortcut : FindShortcuts(state, vertex)) {
+                const EdgeId edge_id = graph_.GetEdgeCount() + shortcuts_.size();
+                shortcuts_.push_back(shortcut);
+                state.out_edges[shortcut.from].push_back(edge_id);
+                state.in_edges[shortcut.to].push_back(edge_id);
+            }
+            for (const EdgeId edge_id : state.in_edges[vertex]) {
+                ++state.contracted_neighbors[GetHierarchyEdge(edge_id).from];
+            }
+            for (const EdgeId edge_id : state.out_edges[vertex]) {
+                ++state.contracted_neighbors[GetHierarchyEdge(edge_id).to];
+            }
+            state.contracted[vertex] = true;
+            ranks_[vertex] = rank++;
+        }
+    }
+
+    void BuildSearchGraph() {
+        const size_t vertex_count = graph_.GetVertexCount();
+        upward_edges_.assign(vertex_count, {});
+        downward_edges_.assign(vertex_count, {});
+
+        const EdgeId edge_count = graph_.GetEdgeCount() + shortcuts_.size();
+        for (EdgeId edge_id = 0; edge_id < edge_count; ++edge_id) {
+            if (edge_id < graph_.GetEdgeCount() && graph_.IsEdgeRemoved(edge_id)) {
+                continue;
+            }
+            const Edge<Weight> edge = GetHierarchyEdge(edge_id);
+            if (edge.from == edge.to) {
+                continue;
+            }
+            if (ranks_[edge.from] < ranks_[edge.to]) {
+                upward_edges_[edge.from].push_back(edge_id);
+            } else {
+                downward_edges_[edge.to].push_back(edge_id);
+            }
+        }
+    }
+
+    void UnpackEdge(EdgeId edge_id, std::vector<EdgeId>& edges) const {
+        std::vector<EdgeId> stack{edge_id};
+        while (!stack.empty()) {
+            const EdgeId current = stack.back();
+            stack.pop_back();
+            if (current < graph_.GetEdgeCount()) {
+                edges.push_back(current);
+            } else {
+                const Shortcut& shortcut = shortcuts_[current - graph_.GetEdgeCount()];
+                stack.push_back(shortcut.second_edge);
+                stack.push_back(shortcut.first_edge);
+            }
+        }
+    }
+
+    // Рабочие массивы запросов, свои у каждого потока: [0] - прямой поиск, [1] - обратный
+    struct SearchScratch {
+        VertexMap<Weight> weights[2];
+        VertexMap<EdgeId> prev_edges[2];
+        MinHeap<QueueItem> queues[2];
+    };
+
+    static SearchScratch& GetScratch(size_t vertex_count) {
+        static thread_local SearchScratch scratch;
+        for (int direction = 0; direction < 2; ++direction) {
+            scratch.weights[direction].Reset(vertex_count);
+            scratch.prev_edges[direction].Reset(vertex_count);
+            scratch.queues[direction].Clear();
+        }
+        return scratch;
+    }
+
+    static constexpr Weight ZERO_WEIGHT{};
+    const Graph& graph_;
+    std::vector<size_t> ranks_;
+    std::vector<Shortcut> shortcuts_;
+    // upward_edges_[v] - рёбра v -> u с ранг(u) > ранг(v),
+    // downward_edges_[v] - рёбра u -> v с ранг(u) > ранг(v)
+    std::vector<std::vector<EdgeId>> upward_edges_;
+    std::vector<std::vector<EdgeId>> downward_edges_;
+};
+
+template <typename Weight>
+ContractionHierarchy<Weight>::ContractionHierarchy(const Graph& graph)
+    : graph_(graph)
+    , ranks_(graph.GetVertexCount())
+{
+    Contract();
+    BuildSearchGraph();
+}
+
+template <typename Weight>
+ContractionHierarchy<Weight>::ContractionHierarchy(const Graph& graph, std::vector<size_t> ranks,
+                                                   std::vector<Shortcut> shortcuts)
+    : graph_(graph)
+    , ranks_(std::move(ranks))
+    , shortcuts_(std::move(shortcuts))
+{
+    if (ranks_.size() != graph.GetVertexCount()) {
+        throw std::invalid_argument("Contraction hierarchy doesn't match the graph");
+    }
+    BuildSearchGraph();
+}
+
+template <typename Weight>
+std::optional<typename ContractionHierarchy<Weight>::RouteInfo> ContractionHierarchy<Weight>::BuildRoute(
+    VertexId from, VertexId to) const {
+    const size_t vertex_count = graph_.GetVertexCount();
+    if (from >= vertex_count || to >= vertex_count) {
+        throw std::out_of_range("Vertex id is out of range");
+    }
+    // [0] - прямой поиск от from, [1] - обратный поиск от to
+    SearchScratch& scratch = GetScratch(vertex_count);
+    auto& weights = scratch.weights;
+    auto& prev_edges = scratch.prev_edges;
+    auto& queues = scratch.queues;
+
+    weights[0].Set(from, ZERO_WEIGHT);
+    weights[1].Set(to, ZERO_WEIGHT);
+    queues[0].Push({ZERO_WEIGHT, from});
+    queues[1].Push({ZERO_WEIGHT, to});
+
+    std::optional<Weight> best_weight;
+    VertexId meeting_vertex = from;
+
+    while (!queues[0].Empty() || !queues[1].Empty()) {
+        const int direction = queues[1].Empty()
+            || (!queues[0].Empty() && queues[0].Top().first <= queues[1].Top().first) ? 0 : 1;
+        auto& queue = queues[direction];
+        const auto [weight, vertex] = queue.Top();
+        queue.Pop();
+
+        if (weight > weights[direction].Get(vertex)) {
+            continue;
+        }
+        if (best_weight && !(weight < *best_weight)) {
+            queue.Clear();
+            continue;
+        }
+        if (const Weight* other_weight = weights[1 - direction].Find(vertex)) {
+            const Weight candidate_weight = weight + *other_weight;
+            if (!best_weight || candidate_weight < *best_weight) {
+                best_weight = candidate_weight;
+                meeting_vertex = vertex;
+            }
+        }
+
+        const auto& edges = direction == 0 ? upward_edges_[vertex] : downward_edges_[vertex];
+        for (const EdgeId edge_id : edges) {
+            const Edge<Weight> edge = GetHierarchyEdge(edge_id);
+            const VertexId next = direction == 0 ? edge.to : edge.from;
+            const Weight candidate_weight = weight + edge.weight;
+            const Weight* weight_next = weights[direction].Find(next);
+            if (!weight_next || candidate_weight < *weight_next) {
+                weights[direction].Set(next, candidate_weight);
+                prev_edges[direction].Set(next, edge_id);
+                queue.Push({candidate_weight, next});
+            }
+        }
+    }
+
+    if (!best_weight) {
+        return std::nullopt;
+    }
+
+    std::vector<EdgeId> forward_edges;
+    for (const EdgeId* edge_id = prev_edges[0].Find(meeting_vertex);
+         edge_id;
+         edge_id = prev_edges[0].Find(GetHierarchyEdge(*edge_id).from))
+    {
+        forward_edges.push_back(*edge_id);
+    }
+    std::reverse(forward_edges.begin(), forward_edges.end());
+
+    std::vector<EdgeId> edges;
+    for (const EdgeId edge_id : forward_edges) {
+        UnpackEdge(edge_id, edges);
+    }
+    for (const EdgeId* edge_id = prev_edges[1].Find(meeting_vertex);
+         edge_id;
+         edge_id = prev_edges[1].Find(GetHierarchyEdge(*edge_id).to))
+    {
+        UnpackEdge(*edge_id, edges);
+    }
+
+    return RouteInfo{*best_weight, std::move(edges)};
+}
+
+template <typename Weight>
+std::vector<std::optional<Weight>> ContractionHierarchy<Weight>::BuildWeights(
+    VertexId from, const std::vector<VertexId>& targets) const {
+    const size_t vertex_count = graph_.GetVertexCount();
+    if (from >= vertex_count) {
+        throw std::out_of_range("Vertex id is out of range");
+    }
+    SearchScratch& scratch = GetScratch(vertex_count);
+    auto& forward_weights = scratch.weights[0];
+    auto& backward_weights = scratch.weights[1];
+    auto& queue = scratch.queues[0];
+
+    forward_weights.Set(from, ZERO_WEIGHT);
+    queue.Push({ZERO_WEIGHT, from});
+    while (!queue.Empty()) {
+        const auto [weight, vertex] = queue.Top();
+        queue.Pop();
+        if (weight > forward_weights.Get(vertex)) {
+            continue;
+        }
+        for (const EdgeId edge_id : upward_edges_[vertex]) {
+            const Edge<Weight> edge = GetHierarchyEdge(edge_id);
+            const Weight candidate_weight = weight + edge.weight;
+            const Weight* weight_next = forward_weights.Find(edge.to);
+            if (!weight_next || candidate_weight < *weight_next) {
+                forward_weights.Set(edge.to, candidate_weight);
+                queue.Push({candidate_weight, edge.to});
+            }
+        }
+    }
+
+    std::vector<std::optional<Weight>> result;
+    result.reserve(targets.size());
+
+    for (const VertexId to : targets) {
+        if (to >= vertex_count) {
+            throw std::out_of_range("Vertex id is out of range");
+        }
+        std::optional<Weight> best_weight;
+        backward_weights.Reset(vertex_count);
+        queue.Clear();
+        backward_weights.Set(to, ZERO_WEIGHT);
+        queue.Push({ZERO_WEIGHT, to});
+
+        while (!queue.Empty()) {
+            const auto [weight, vertex] = queue.Top();
+            queue.Pop();
+            if (weight > backward_weights.Get(vertex)) {
+                continue;
+            }
+            if (best_weight && !(weight < *best_weight)) {
+                break;
+            }
+            if (const Weight* forward_weight = forward_weights.Find(vertex)) {
+                const Weight candidate_weight = weight + *forward_weight;
+                if (!best_weight || candidate_weight < *best_weight) {
+                    best_weight = candidate_weight;
+                }
+            }
+            for (const EdgeId edge_id : downward_edges_[vertex]) {
+                const Edge<Weight> edge = GetHierarchyEdge(edge_id);
+                const Weight candidate_weight = weight + edge.weight;
+                const Weight* weight_next = backward_weights.Find(edge.from);
+                if (!weight_next || candidate_weight < *weight_next) {
+                    backward_weights.Set(edge.from, candidate_weight);
+                    queue.Push({candidate_weight, edge.from});
+                }
+            }
+        }
+
+        result.push_back(best_weight);
+    }
+    return result;
+}
+
+}  // namespace graph
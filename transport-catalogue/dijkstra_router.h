@@ -0,0 +1,363 @@
+#pragma once
+
+#include "router.h"
+#include "search_scratch.h"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <optional>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+// Ищет маршрут алгоритмом Дейкстры в момент запроса: предвычислений нет,
+// память на запрос линейна по числу вершин. С эвристикой поиск становится A*.
+// Graph - DirectedWeightedGraph или его замороженная CSR-копия CsrGraph
+template <typename Weight, typename Graph = DirectedWeightedGraph<Weight>>
+class DijkstraRouter final : public RouterBase<Weight> {
+public:
+    using RouteInfo = typename RouterBase<Weight>::RouteInfo;
+
+    // Нижняя оценка веса пути из vertex в target. Оценка должна быть допустимой
+    // (не больше настоящего веса), иначе найденный маршрут может быть не кратчайшим.
+    // При целых весах без знака оценка должна быть ещё и согласованной: очередь монотонна
+    using Heuristic = std::function<Weight(VertexId vertex, VertexId target)>;
+
+    // Суммарные счётчики по всем запросам
+    struct Statistics {
+        size_t query_count = 0;
+        size_t settled_vertex_count = 0;
+    };
+
+    explicit DijkstraRouter(const Graph& graph, Heuristic heuristic = nullptr);
+
+    std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to) const override;
+    // Один поиск без эвристики до тех пор, пока не будут достигнуты все цели
+    std::vector<std::optional<Weight>> BuildWeights(VertexId from, const std::vector<VertexId>& targets) const override;
+    // Маршруты до каждой из targets одним поиском без эвристики
+    std::vector<std::optional<RouteInfo>> BuildRoutes(VertexId from, const std::vector<VertexId>& targets) const;
+    // Все вершины с весом пути не больше max_weight в порядке неубывания веса;
+    // вершины дальше max_weight в очередь не попадают, и поиск на них заканчивается
+    std::vector<std::pair<VertexId, Weight>> BuildWeightsWithin(VertexId from, Weight max_weight) const;
+
+    Statistics GetStatistics() const {
+        return {query_count_.load(), settled_vertex_count_.load()};
+    }
+
+private:
+    // Приоритет в очереди (вес + оценка остатка), вес пути до вершины, вершина
+    using QueueItem = std::tuple<Weight, Weight, VertexId>;
+    // Целые веса без знака позволяют очередь по разрядам вместо двоичной кучи
+    using Queue = std::conditional_t<std::is_integral_v<Weight> && std::is_unsigned_v<Weight>,
+                                     RadixHeap<QueueItem>,
+                                     MinHeap<QueueItem>>;
+
+    template <typename Relax>
+    void ForEachOutgoingEdge(VertexId vertex, Relax relax) const {
+        if constexpr (std::is_same_v<Graph, CsrGraph<Weight>>) {
+            for (const auto& edge : graph_.GetOutgoingEdges(vertex)) {
+                relax(edge.id, edge.to, edge.weight);
+            }
+        } else {
+            for (const EdgeId edge_id : graph_.GetIncidentEdges(vertex)) {
+                const auto& edge = graph_.GetEdge(edge_id);
+                relax(edge_id, edge.to, edge.weight);
+            }
+        }
+    }
+
+    // Последнее ребро найденного пути и вершина, из которой оно выходит
+    struct PrevEdge {
+        EdgeId edge;
+        VertexId from;
+    };
+
+    // Рабочие массивы поиска: свои у каждого потока и общие для всех его запросов,
+    // поэтому запрос не выделяет память размером с граф и потоки не делят кэш-линии
+    struct SearchScratch {
+        VertexMap<Weight> weights;
+        VertexMap<PrevEdge> prev_edges;
+        VertexMap<Weight> estimates;
+        Queue queue;
+    };
+
+    static SearchScratch& GetScratch(size_t vertex_count) {
+        static thread_local SearchScratch scratch;
+        scratch.weights.Reset(vertex_count);
+        scratch.prev_edges.Reset(vertex_count);
+        scratch.estimates.Reset(vertex_count);
+        scratch.queue.Clear();
+        return scratch;
+    }
+
+    static constexpr Weight ZERO_WEIGHT{};
+    const Graph& graph_;
+    Heuristic heuristic_;
+
+    mutable std::atomic<size_t> query_count_ = 0;
+    mutable std::atomic<size_t> settled_vertex_count_ = 0;
+};
+
+template <typename Weight, typename Graph>
+DijkstraRouter<Weight, Graph>::DijkstraRouter(const Graph& graph, Heuristic heuristic)
+    : graph_(graph)
+    , heuristic_(std::move(heuristic))
+{
+    for (VertexId vertex = 0; vertex < graph.GetVertexCount(); ++vertex) {
+        ForEachOutgoingEdge(vertex, [](EdgeId, VertexId, Weight edge_weight) {
+            if (edge_weight < ZERO_WEIGHT) {
+                throw std::domain_error("Edges' weights should be non-negative");
+            }
+        });
+    }
+}
+
+template <typename Weight, typename Graph>
+std::optional<typename DijkstraRouter<Weight, Graph>::RouteInfo> DijkstraRouter<Weight, Graph>::BuildRoute(
+    VertexId from, VertexId to) const {
+    const size_t vertex_count = graph_.GetVertexCount();
+    if (from >= vertex_count || to >= vertex_count) {
+        throw std::out_of_range("Vertex id is out of range");
+    }
+    SearchScratch& scratch = GetScratch(vertex_count);
+    auto& weights = scratch.weights;
+    auto& prev_edges = scratch.prev_edges;
+    auto& queue = scratch.queue;
+
+    // Оценки остатка пути считаются один раз на вершину
+    auto estimate = [&](VertexId vertex) {
+        if (!heuristic_) {
+            return ZERO_WEIGHT;
+        }
+        if (const Weight* cached_estimate = scratch.estimates.Find(vertex)) {
+            return *cached_estimate;
+        }
+        const Weight result = heuristic_(vertex, to);
+        scratch.estimates.Set(vertex, result);
+        return result;
+    };
+
+    weights.Set(from, ZERO_WEIGHT);
+    queue.Push({estimate(from), ZERO_WEIGHT, from});
+
+    size_t settled_vertex_count = 0;
+    while (!queue.Empty()) {
+        const Weight weight = std::get<1>(queue.Top());
+        const VertexId vertex = std::get<2>(queue.Top());
+        queue.Pop();
+        if (weight > weights.Get(vertex)) {
+            continue;
+        }
+        ++settled_vertex_count;
+        if (vertex == to) {
+            break;
+        }
+        ForEachOutgoingEdge(vertex, [&](EdgeId edge_id, VertexId edge_to, Weight edge_weight) {
+            const Weight candidate_weight = weight + edge_weight;
+            const Weight* weight_to = weights.Find(edge_to);
+            if (!weight_to || candidate_weight < *weight_to) {
+                weights.Set(edge_to, candidate_weight);
+                prev_edges.Set(edge_to, PrevEdge{edge_id, vertex});
+                queue.Push({candidate_weight + estimate(edge_to), candidate_weight, edge_to});
+            }
+        });
+    }
+
+    ++query_count_;
+    settled_vertex_count_ += settled_vertex_count;
+
+    if (!weights.Contains(to)) {
+        return std::nullopt;
+    }
+
+    std::vector<EdgeId> edges;
+    for (const PrevEdge* prev_edge = prev_edges.Find(to);
+         prev_edge;
+         prev_edge = prev_edges.Find(prev_edge->from))
+    {
+        edges.push_back(prev_edge->edge);
+    }
+    std::reverse(edges.begin(), edges.end());
+
+    return RouteInfo{weights.Get(to), std::move(edges)};
+}
+
+template <typename Weight, typename Graph>
+std::vector<std::optional<Weight>> DijkstraRouter<Weight, Graph>::BuildWeights(
+    VertexId from, const std::vector<VertexId>& targets) const {
+    const size_t vertex_count = graph_.GetVertexCount();
+    if (from >= vertex_count) {
+        throw std::out_of_range("Vertex id is out of range");
+    }
+    SearchScratch& scratch = GetScratch(vertex_count);
+    auto& weights = scratch.weights;
+    auto& queue = scratch.queue;
+
+    // оценки в этом поиске не нужны, их массив отмечает цели
+    auto& is_target = scratch.estimates;
+    size_t remaining_target_count = 0;
+    for (const VertexId to : targets) {
+        if (to >= vertex_count) {
+            throw std::out_of_range("Vertex id is out of range");
+        }
+        if (!is_target.Contains(to)) {
+            is_target.Set(to, ZERO_WEIGHT);
+            ++remaining_target_count;
+        }
+    }
+
+    weights.Set(from, ZERO_WEIGHT);
+    queue.Push({ZERO_WEIGHT, ZERO_WEIGHT, from});
+
+    size_t settled_vertex_count = 0;
+    while (!queue.Empty() && remaining_target_count > 0) {
+        const Weight weight = std::get<1>(queue.Top());
+        const VertexId vertex = std::get<2>(queue.Top());
+        queue.Pop();
+        if (weight > weights.Get(vertex)) {
+            continue;
+        }
+        ++settled_vertex_count;
+        if (is_target.Contains(vertex)) {
+            --remaining_target_count;
+        }
+        ForEachOutgoingEdge(vertex, [&](EdgeId, VertexId edge_to, Weight edge_weight) {
+            const Weight candidate_weight = weight + edge_weight;
+            const Weight* weight_to = weights.Find(edge_to);
+            if (!weight_to || candidate_weight < *weight_to) {
+                weights.Set(edge_to, candidate_weight);
+                queue.Push({candidate_weight, candidate_weight, edge_to});
+            }
+        });
+    }
+
+    ++query_count_;
+    settled_vertex_count_ += settled_vertex_count;
+
+    std::vector<std::optional<Weight>> result;
+    result.reserve(targets.size());
+    for (const VertexId to : targets) {
+        const Weight* weight = weights.Find(to);
+        result.push_back(weight ? std::optional<Weight>(*weight) : std::nullopt);
+    }
+    return result;
+}
+
+template <typename Weight, typename Graph>
+std::vector<std::optional<typename DijkstraRouter<Weight, Graph>::RouteInfo>> DijkstraRouter<Weight, Graph>::BuildRoutes(
+    VertexId from, const std::vector<VertexId>& targets) const {
+    const size_t vertex_count = graph_.GetVertexCount();
+    if (from >= vertex_count) {
+        throw std::out_of_range("Vertex id is out of range");
+    }
+    SearchScratch& scratch = GetScratch(vertex_count);
+    auto& weights = scratch.weights;
+    auto& prev_edges = scratch.prev_edges;
+    auto& queue = scratch.queue;
+
+    auto& is_target = scratch.estimates;
+    size_t remaining_target_count = 0;
+    for (const VertexId to : targets) {
+        if (to >= vertex_count) {
+            throw std::out_of_range("Vertex id is out of range");
+        }
+        if (!is_target.Contains(to)) {
+            is_target.Set(to, ZERO_WEIGHT);
+            ++remaining_target_count;
+        }
+    }
+
+    weights.Set(from, ZERO_WEIGHT);
+    queue.Push({ZERO_WEIGHT, ZERO_WEIGHT, from});
+
+    size_t settled_vertex_count = 0;
+    while (!queue.Empty() && remaining_target_count > 0) {
+        const Weight weight = std::get<1>(queue.Top());
+        const VertexId vertex = std::get<2>(queue.Top());
+        queue.Pop();
+        if (weight > weights.Get(vertex)) {
+            continue;
+        }
+        ++settled_vertex_count;
+        if (is_target.Contains(vertex)) {
+            --remaining_target_count;
+        }
+        ForEachOutgoingEdge(vertex, [&](EdgeId edge_id, VertexId edge_to, Weight edge_weight) {
+            const Weight candidate_weight = weight + edge_weight;
+            const Weight* weight_to = weights.Find(edge_to);
+            if (!weight_to || candidate_weight < *weight_to) {
+                weights.Set(edge_to, candidate_weight);
+                prev_edges.Set(edge_to, PrevEdge{edge_id, vertex});
+                queue.Push({candidate_weight, candidate_weight, edge_to});
+            }
+        });
+    }
+
+    ++query_count_;
+    settled_vertex_count_ += settled_vertex_count;
+
+    std::vector<std::optional<RouteInfo>> result;
+    result.reserve(targets.size());
+    for (const VertexId to : targets) {
+        if (!weights.Contains(to)) {
+            result.push_back(std::nullopt);
+            continue;
+        }
+        std::vector<EdgeId> edges;
+        for (const PrevEdge* prev_edge = prev_edges.Find(to);
+             prev_edge;
+             prev_edge = prev_edges.Find(prev_edge->from))
+        {
+            edges.push_back(prev_edge->edge);
+        }
+        std::reverse(edges.begin(), edges.end());
+        result.push_back(RouteInfo{weights.Get(to), std::move(edges)});
+    }
+    return result;
+}
+
+template <typename Weight, typename Graph>
+std::vector<std::pair<VertexId, Weight>> DijkstraRouter<Weight, Graph>::BuildWeightsWithin(
+    VertexId from, Weight max_weight) const {
+    const size_t vertex_count = graph_.GetVertexCount();
+    if (from >= vertex_count) {
+        throw std::out_of_range("Vertex id is out of range");
+    }
+    SearchScratch& scratch = GetScratch(vertex_count);
+    auto& weights = scratch.weights;
+    auto& queue = scratch.queue;
+    std::vector<std::pair<VertexId, Weight>> result;
+
+    weights.Set(from, ZERO_WEIGHT);
+    queue.Push({ZERO_WEIGHT, ZERO_WEIGHT, from});
+
+    while (!queue.Empty()) {
+        const Weight weight = std::get<1>(queue.Top());
+        const VertexId vertex = std::get<2>(queue.Top());
+        queue.Pop();
+        if (weight > weights.Get(vertex)) {
+            continue;
+        }
+        result.emplace_back(vertex, weight);
+        ForEachOutgoingEdge(vertex, [&](EdgeId, VertexId edge_to, Weight edge_weight) {
+            const Weight candidate_weight = weight + edge_weight;
+            const Weight* weight_to = weights.Find(edge_to);
+            if (candidate_weight <= max_weight && (!weight_to || candidate_weight < *weight_to)) {
+                weights.Set(edge_to, candidate_weight);
+                queue.Push({candidate_weight, candidate_weight, edge_to});
+            }
+        });
+    }
+
+    ++query_count_;
+    settled_vertex_count_ += result.size();
+
+    return result;
+}
+
+}  // namespace graph
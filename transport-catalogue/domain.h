@@ -23,16 +23,19 @@ namespace transport_catalogue {
 
 struct Bus;
 
+// id - индекс в справочнике, назначается при добавлении
 struct Stop {
     std::string name;
     geo::Coordinates coord;
     std::vector<Bus*> buses;
+    size_t id = 0;
 };
 
 struct Bus {
     std::string name;
     std::vector<Stop*> stops;
     bool is_roundtrip;
+    size_t id = 0;
 };
 
 struct StatRequest {
@@ -41,6 +44,22 @@ struct StatRequest {
     std::string type;
     std::string from;
     std::string to;
+    // для запросов Matrix и ArriveBy
+    std::vector<std::string> from_list;
+    std::vector<std::string> to_list;
+    // для запроса Isochrone: бюджет времени в минутах и нужна ли картинка оболочки
+    double max_time = 0;
+    bool render_hull = false;
+    // для запроса Route: нужны ли ещё маршруты, оптимальные по Парето по времени и числу поездок
+    bool pareto = false;
+    // для запроса ArriveBy: к какому времени, в минутах, нужно прибыть на остановку to
+    double arrive_by = 0;
+};
+
+// Как выполняется пакет запросов process_requests: thread_count - число потоков,
+// 0 - по числу ядер. Ответы всегда идут в порядке запросов
+struct ExecutionSettings {
+    size_t thread_count = 1;
 };
 
 } //end namespace transport_catalogue
\ No newline at end of file
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "dijkstra_router.h"
+#include "graph.h"
+#include "router.h"
+
+#include <cmath>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+// Копия графа с весами в целых единицах: вес ребра умножается на scale и округляется.
+// Удалённые рёбра остаются удалёнными, поэтому id рёбер в копии те же
+template <typename Integer>
+DirectedWeightedGraph<Integer> ToFixedPoint(const DirectedWeightedGraph<double>& graph, double scale) {
+    static_assert(std::is_integral_v<Integer> && std::is_unsigned_v<Integer>, "Fixed-point weights should be unsigned integers");
+
+    DirectedWeightedGraph<Integer> result(graph.GetVertexCount());
+    for (EdgeId edge_id = 0; edge_id < graph.GetEdgeCount(); ++edge_id) {
+        const Edge<double>& edge = graph.GetEdge(edge_id);
+        const double weight = std::round(edge.weight * scale);
+        if (!(weight >= 0) || weight > static_cast<double>(std::numeric_limits<Integer>::max())) {
+            throw std::out_of_range("Edge weight does not fit into the fixed-point type");
+        }
+        result.AddEdge(Edge<Integer>{edge.from, edge.to, static_cast<Integer>(weight)});
+        if (graph.IsEdgeRemoved(edge_id)) {
+            result.RemoveEdge(edge_id);
+        }
+    }
+    return result;
+}
+
+// Дейкстра по целочисленной CSR-копии графа: сравнения точные,
+// очередь - RadixHeap вместо двоичной кучи. Маршрут ищется по целым весам,
+// а его вес складывается из весов рёбер исходного графа в порядке пути - так же,
+// как его складывает Дейкстра по исходному графу. Маршруты, которые отличаются
+// меньше чем на единицу целого веса, могут считаться равными.
+// Сумма весов пути должна помещаться в Integer
+template <typename Integer>
+class FixedPointRouter final : public RouterBase<double> {
+public:
+    FixedPointRouter(const DirectedWeightedGraph<double>& graph, double scale)
+        : graph_(graph)
+        , csr_graph_(ToFixedPoint<Integer>(graph, scale))
+        , router_(csr_graph_)
+    {
+    }
+
+    std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to) const override {
+        auto route = router_.BuildRoute(from, to);
+        if (!route) {
+            return std::nullopt;
+        }
+
+        double weight = 0;
+        for (const EdgeId edge_id : route->edges) {
+            weight += graph_.GetEdge(edge_id).weight;
+        }
+        return RouteInfo{weight, std::move(route->edges)};
+    }
+
+    typename DijkstraRouter<Integer, CsrGraph<Integer>>::Statistics GetStatistics() const {
+        return router_.GetStatistics();
+    }
+
+private:
+    const DirectedWeightedGraph<double>& graph_;
+    CsrGraph<Integer> csr_graph_;
+    DijkstraRouter<Integer, CsrGraph<Integer>> router_;
+};
+
+}  // namespace graph
@@ -1,7 +1,11 @@
 #define _USE_MATH_DEFINES
 #include "geo.h"
 
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
 
 namespace geo {
 
@@ -16,4 +20,151 @@ double ComputeDistance(Coordinates from, Coordinates to) {
         * 6371000;
 }
 
-}  // namespace geo
\ No newline at end of file
+// Алгоритм Эндрю: нижняя и верхняя цепочки по точкам, упорядоченным по долготе
+std::vector<Coordinates> ComputeConvexHull(std::vector<Coordinates> points) {
+    std::sort(points.begin(), points.end(), [](const Coordinates& lhs, const Coordinates& rhs) {
+        return lhs.lng < rhs.lng || (lhs.lng == rhs.lng && lhs.lat < rhs.lat);
+    });
+    points.erase(std::unique(points.begin(), points.end()), points.end());
+    if (points.size() < 3) {
+        return points;
+    }
+    
+    auto cross = [](const Coordinates& origin, const Coordinates& lhs, const Coordinates& rhs) {
+        return (lhs.lng - origin.lng) * (rhs.lat - origin.lat) - (lhs.lat - origin.lat) * (rhs.lng - origin.lng);
+    };
+    
+    std::vector<Coordinates> result(2 * points.size());
+    size_t size = 0;
+    for (size_t i = 0; i < points.size(); ++i) {
+        while (size >= 2 && cross(result[size - 2], result[size - 1], points[i]) <= 0) {
+            --size;
+        }
+        result[size++] = points[i];
+    }
+    for (size_t i = points.size() - 1, lower_size = size + 1; i > 0; --i) {
+        while (size >= lower_size && cross(result[size - 2], result[size - 1], points[i - 1]) <= 0) {
+            --size;
+        }
+        result[size++] = points[i - 1];
+    }
+    // последняя точка верхней цепочки совпадает с первой
+    result.resize(size - 1);
+    
+    return result;
+}
+
+std::vector<std::pair<size_t, size_t>> FindClosePairs(const std::vector<Coordinates>& points, double max_distance) {
+    std::vector<std::pair<size_t, size_t>> result;
+    if (points.empty() || max_distance < 0) {
+        return result;
+    }
+    
+    static const double meters_per_degree = M_PI / 180. * 6371000;
+    // с запасом на погрешность: лишние точки в ячейке отсеет точное расстояние
+    const double lat_step = std::max(max_distance / meters_per_degree * 1.01, 1e-9);
+    double max_abs_lat = 0;
+    for (const Coordinates& point : points) {
+        max_abs_lat = std::max(max_abs_lat, std::abs(point.lat));
+    }
+    // градус долготы короче всего на самой дальней от экватора широте
+    const double min_cos_lat = std::cos(std::min(max_abs_lat + lat_step, 90.) * M_PI / 180.);
+    const double lng_step = min_cos_lat > lat_step / 360. ? lat_step / min_cos_lat : 360.;
+    
+    using Cell = std::pair<int64_t, int64_t>;
+    struct CellHasher {
+        size_t operator()(const Cell& cell) const {
+            return std::hash<int64_t>{}(cell.first) * 37 + std::hash<int64_t>{}(cell.second);
+        }
+    };
+    
+    auto get_cell = [lat_step, lng_step](const Coordinates& point) {
+        return Cell{static_cast<int64_t>(std::floor(point.lat / lat_step)),
+                    static_cast<int64_t>(std::floor(point.lng / lng_step))};
+    };
+    
+    std::unordered_map<Cell, std::vector<size_t>, CellHasher> cells;
+    for (size_t index = 0; index < points.size(); ++index) {
+        cells[get_cell(points[index])].push_back(index);
+    }
+    
+    for (size_t index = 0; index < points.size(); ++index) {
+        const auto [row, column] = get_cell(points[index]);
+        for (int64_t neighbor_row = row - 1; neighbor_row <= row + 1; ++neighbor_row) {
+            for (int64_t neighbor_column = column - 1; neighbor_column <= column + 1; ++neighbor_column) {
+                const auto it = cells.find(Cell{neighbor_row, neighbor_column});
+                if (it == cells.end()) {
+                    continue;
+                }
+                for (const size_t other : it->second) {
+                    if (other > index && ComputeDistance(points[index], points[other]) <= max_distance) {
+                        result.emplace_back(index, other);
+                    }
+                }
+            }
+        }
+    }
+    
+    return result;
+}
+
+std::vector<size_t> OrderAlongHilbertCurve(const std::vector<Coordinates>& points) {
+    static constexpr uint32_t GRID_SIDE = 1u << 16;
+    
+    std::vector<size_t> result(points.size());
+    for (size_t index = 0; index < points.size(); ++index) {
+        result[index] = index;
+    }
+    if (points.size() < 2) {
+        return result;
+    }
+    
+    double min_lat = points.front().lat;
+    double max_lat = points.front().lat;
+    double min_lng = points.front().lng;
+    double max_lng = points.front().lng;
+    for (const Coordinates& point : points) {
+        min_lat = std::min(min_lat, point.lat);
+        max_lat = std::max(max_lat, point.lat);
+        min_lng = std::min(min_lng, point.lng);
+        max_lng = std::max(max_lng, point.lng);
+    }
+    
+    auto to_grid = [](double value, double min_value, double max_value) {
+        if (!(max_value > min_value)) {
+            return uint32_t{0};
+        }
+        const double cell = (value - min_value) / (max_value - min_value) * GRID_SIDE;
+        return static_cast<uint32_t>(std::min(cell, static_cast<double>(GRID_SIDE - 1)));
+    };
+    
+    // номер клетки на кривой: на каждом уровне выбирается четверть, и координаты
+    // поворачиваются так, чтобы кривая внутри четверти шла из её входа в выход
+    std::vector<uint64_t> curve_indices(points.size());
+    for (size_t index = 0; index < points.size(); ++index) {
+        uint32_t x = to_grid(points[index].lng, min_lng, max_lng);
+        uint32_t y = to_grid(points[index].lat, min_lat, max_lat);
+        uint64_t curve_index = 0;
+        for (uint32_t side = GRID_SIDE / 2; side > 0; side /= 2) {
+            const uint32_t right = (x & side) ? 1 : 0;
+            const uint32_t top = (y & side) ? 1 : 0;
+            curve_index += static_cast<uint64_t>(side) * side * ((3 * right) ^ top);
+            if (top == 0) {
+                if (right == 1) {
+                    x = GRID_SIDE - 1 - x;
+                    y = GRID_SIDE - 1 - y;
+                }
+                std::swap(x, y);
+            }
+        }
+        curve_indices[index] = curve_index;
+    }
+    
+    std::stable_sort(result.begin(), result.end(), [&curve_indices](size_t lhs, size_t rhs) {
+        return curve_indices[lhs] < curve_indices[rhs];
+    });
+    
+    return result;
+}
+
+}  // namespace geo
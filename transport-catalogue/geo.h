@@ -1,5 +1,9 @@
 #pragma once
 
+#include <cstddef>
+#include <utility>
+#include <vector>
+
 namespace geo {
 
 struct Coordinates {
@@ -15,4 +19,17 @@ struct Coordinates {
 
 double ComputeDistance(Coordinates from, Coordinates to);
 
+// Выпуклая оболочка точек на плоскости (долгота, широта) против часовой стрелки,
+// без повторения первой точки в конце
+std::vector<Coordinates> ComputeConvexHull(std::vector<Coordinates> points);
+
+// Все пары индексов точек (i < j), между которыми не больше max_distance метров. Точки лежат
+// в ячейках сетки со стороной не меньше max_distance, и каждая сравнивается только с точками
+// своей и соседних ячеек. Переход через 180-й меридиан не учитывается
+std::vector<std::pair<size_t, size_t>> FindClosePairs(const std::vector<Coordinates>& points, double max_distance);
+
+// Индексы точек в порядке обхода кривой Гильберта по сетке 2^16 x 2^16 на ограничивающем
+// прямоугольнике: близкие точки чаще всего оказываются рядом в порядке обхода
+std::vector<size_t> OrderAlongHilbertCurve(const std::vector<Coordinates>& points);
+
 }  // namespace geo
\ No newline at end of file
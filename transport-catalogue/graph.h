@@ -2,7 +2,9 @@
 
 #include "ranges.h"
 
+#include <algorithm>
 #include <cstdlib>
+#include <iterator>
 #include <vector>
 
 namespace graph {
@@ -27,14 +29,21 @@ public:
     DirectedWeightedGraph() = default;
     explicit DirectedWeightedGraph(size_t vertex_count);
     EdgeId AddEdge(const Edge<Weight>& edge);
+    VertexId AddVertex();
+    // Удалённое ребро пропадает из списков смежности, но сохраняет свой id:
+    // id остальных рёбер не меняются, GetEdgeCount() учитывает и удалённые рёбра
+    void RemoveEdge(EdgeId edge_id);
+    void SetEdgeWeight(EdgeId edge_id, Weight weight);
 
     size_t GetVertexCount() const;
     size_t GetEdgeCount() const;
     const Edge<Weight>& GetEdge(EdgeId edge_id) const;
+    bool IsEdgeRemoved(EdgeId edge_id) const;
     IncidentEdgesRange GetIncidentEdges(VertexId vertex) const;
 
 private:
     std::vector<Edge<Weight>> edges_;
+    std::vector<bool> removed_edges_;
     std::vector<IncidenceList> incidence_lists_;
 };
 
@@ -46,11 +55,33 @@ DirectedWeightedGraph<Weight>::DirectedWeightedGraph(size_t vertex_count)
 template <typename Weight>
 EdgeId DirectedWeightedGraph<Weight>::AddEdge(const Edge<Weight>& edge) {
     edges_.push_back(edge);
+    removed_edges_.push_back(false);
     const EdgeId id = edges_.size() - 1;
     incidence_lists_.at(edge.from).push_back(id);
     return id;
 }
 
+template <typename Weight>
+VertexId DirectedWeightedGraph<Weight>::AddVertex() {
+    incidence_lists_.emplace_back();
+    return incidence_lists_.size() - 1;
+}
+
+template <typename Weight>
+void DirectedWeightedGraph<Weight>::RemoveEdge(EdgeId edge_id) {
+    if (removed_edges_.at(edge_id)) {
+        return;
+    }
+    removed_edges_[edge_id] = true;
+    IncidenceList& incidence_list = incidence_lists_[edges_[edge_id].from];
+    incidence_list.erase(std::find(incidence_list.begin(), incidence_list.end(), edge_id));
+}
+
+template <typename Weight>
+void DirectedWeightedGraph<Weight>::SetEdgeWeight(EdgeId edge_id, Weight weight) {
+    edges_.at(edge_id).weight = weight;
+}
+
 template <typename Weight>
 size_t DirectedWeightedGraph<Weight>::GetVertexCount() const {
     return incidence_lists_.size();
@@ -66,9 +97,107 @@ const Edge<Weight>& DirectedWeightedGraph<Weight>::GetEdge(EdgeId edge_id) const
     return edges_.at(edge_id);
 }
 
+template <typename Weight>
+bool DirectedWeightedGraph<Weight>::IsEdgeRemoved(EdgeId edge_id) const {
+    return removed_edges_.at(edge_id);
+}
+
 template <typename Weight>
 typename DirectedWeightedGraph<Weight>::IncidentEdgesRange
 DirectedWeightedGraph<Weight>::GetIncidentEdges(VertexId vertex) const {
     return ranges::AsRange(incidence_lists_.at(vertex));
 }
+
+// Замороженная копия DirectedWeightedGraph в формате CSR (compressed sparse row):
+// исходящие рёбра вершины вместе с концами и весами лежат в памяти подряд,
+// поэтому обход соседей не требует косвенных обращений
+template <typename Weight>
+class CsrGraph {
+public:
+    struct OutgoingEdge {
+        VertexId to;
+        Weight weight;
+        EdgeId id;
+    };
+
+private:
+    using OutgoingEdgesRange = ranges::Range<typename std::vector<OutgoingEdge>::const_iterator>;
+
+public:
+    explicit CsrGraph(const DirectedWeightedGraph<Weight>& graph);
+    // Развёрнутая копия: исходящие рёбра вершины v - входящие в v рёбра graph,
+    // to - их начало, id те же. Поиск по ней идёт от конца маршрута к началу
+    static CsrGraph Reversed(const DirectedWeightedGraph<Weight>& graph);
+
+    size_t GetVertexCount() const;
+    size_t GetEdgeCount() const;
+    // Без проверки границ: vertex должна быть меньше GetVertexCount()
+    OutgoingEdgesRange GetOutgoingEdges(VertexId vertex) const;
+
+private:
+    CsrGraph() = default;
+
+    // Рёбра вершины v - outgoing_edges_[offsets_[v]..offsets_[v + 1])
+    std::vector<size_t> offsets_;
+    std::vector<OutgoingEdge> outgoing_edges_;
+};
+
+template <typename Weight>
+CsrGraph<Weight>::CsrGraph(const DirectedWeightedGraph<Weight>& graph)
+    : offsets_(graph.GetVertexCount() + 1, 0)
+{
+    const size_t vertex_count = graph.GetVertexCount();
+
+    outgoing_edges_.reserve(graph.GetEdgeCount());
+    for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+        for (const EdgeId edge_id : graph.GetIncidentEdges(vertex)) {
+            const Edge<Weight>& edge = graph.GetEdge(edge_id);
+            outgoing_edges_.push_back(OutgoingEdge{edge.to, edge.weight, edge_id});
+        }
+        offsets_[vertex + 1] = outgoing_edges_.size();
+    }
+}
+
+template <typename Weight>
+CsrGraph<Weight> CsrGraph<Weight>::Reversed(const DirectedWeightedGraph<Weight>& graph) {
+    const size_t vertex_count = graph.GetVertexCount();
+    CsrGraph result;
+    result.offsets_.assign(vertex_count + 1, 0);
+
+    // подсчётом: сначала число входящих рёбер каждой вершины, потом рёбра по местам
+    for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+        for (const EdgeId edge_id : graph.GetIncidentEdges(vertex)) {
+            ++result.offsets_[graph.GetEdge(edge_id).to + 1];
+        }
+    }
+    for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+        result.offsets_[vertex + 1] += result.offsets_[vertex];
+    }
+
+    result.outgoing_edges_.resize(result.offsets_[vertex_count]);
+    std::vector<size_t> next_slots(result.offsets_.begin(), std::prev(result.offsets_.end()));
+    for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+        for (const EdgeId edge_id : graph.GetIncidentEdges(vertex)) {
+            const Edge<Weight>& edge = graph.GetEdge(edge_id);
+            result.outgoing_edges_[next_slots[edge.to]++] = OutgoingEdge{edge.from, edge.weight, edge_id};
+        }
+    }
+    return result;
+}
+
+template <typename Weight>
+size_t CsrGraph<Weight>::GetVertexCount() const {
+    return offsets_.size() - 1;
+}
+
+template <typename Weight>
+size_t CsrGraph<Weight>::GetEdgeCount() const {
+    return outgoing_edges_.size();
+}
+
+template <typename Weight>
+typename CsrGraph<Weight>::OutgoingEdgesRange CsrGraph<Weight>::GetOutgoingEdges(VertexId vertex) const {
+    return OutgoingEdgesRange{outgoing_edges_.begin() + offsets_[vertex],
+                              outgoing_edges_.begin() + offsets_[vertex + 1]};
+}
 }  // namespace graph
\ No newline at end of file
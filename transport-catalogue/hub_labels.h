@@ -0,0 +1,520 @@
+#pragma once
+
+#include "router.h"
+#include "search_scratch.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+// Разметка хабами (hub labeling): у каждой вершины v есть исходящая метка - хабы,
+// достижимые из v, с расстояниями до них, и входящая - хабы, из которых достижима v.
+// Для любой пары from, to общий хаб двух меток лежит на кратчайшем пути, поэтому запрос -
+// слияние двух отсортированных меток без обхода графа. Метки строятся обрезанными
+// поисками Дейкстры от вершин в порядке важности (pruned landmark labeling)
+template <typename Weight>
+class HubLabels final : public RouterBase<Weight> {
+private:
+    using Graph = DirectedWeightedGraph<Weight>;
+
+public:
+    using RouteInfo = typename RouterBase<Weight>::RouteInfo;
+
+    static constexpr uint32_t NO_EDGE = std::numeric_limits<uint32_t>::max();
+
+    // Метки всех вершин подряд в плоских массивах: метка вершины v - позиции
+    // [offsets[v], offsets[v + 1]), hubs - ранги хабов по возрастанию, weights - расстояния.
+    // parent_edges - ребро пути к хабу, соседнее с v (NO_EDGE у самого хаба): по нему
+    // путь раскрывается через метки следующих вершин с тем же хабом
+    struct LabelSet {
+        std::vector<uint32_t> offsets;
+        std::vector<uint32_t> hubs;
+        std::vector<Weight> weights;
+        std::vector<uint32_t> parent_edges;
+    };
+
+    explicit HubLabels(const Graph& graph);
+    // Восстанавливает разметку по сохранённому порядку вершин (order[rank] - вершина) и меткам
+    HubLabels(const Graph& graph, std::vector<uint32_t> order, LabelSet out_labels, LabelSet in_labels);
+
+    std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to) const override;
+    std::vector<std::optional<Weight>> BuildWeights(VertexId from, const std::vector<VertexId>& targets) const override;
+
+    const std::vector<uint32_t>& GetOrder() const {
+        return order_;
+    }
+    const LabelSet& GetOutLabels() const {
+        return out_labels_;
+    }
+    const LabelSet& GetInLabels() const {
+        return in_labels_;
+    }
+
+private:
+    using QueueItem = std::pair<Weight, VertexId>;
+
+    struct LabelEntry {
+        uint32_t hub;
+        Weight weight;
+        uint32_t parent_edge;
+    };
+
+    // Кратчайшее расстояние через общий хаб и позиции этого хаба в обеих метках
+    struct Meeting {
+        Weight weight;
+        size_t out_position;
+        size_t in_position;
+    };
+
+    static std::optional<Meeting> MergeLabels(const LabelSet& out_labels, VertexId from,
+                                              const LabelSet& in_labels, VertexId to) {
+        std::optional<Meeting> result;
+        size_t out_position = out_labels.offsets[from];
+        size_t in_position = in_labels.offsets[to];
+        const size_t out_end = out_labels.offsets[from + 1];
+        const size_t in_end = in_labels.offsets[to + 1];
+
+        while (out_position < out_end && in_position < in_end) {
+            const uint32_t out_hub = out_labels.hubs[out_position];
+            const uint32_t in_hub = in_labels.hubs[in_position];
+            if (out_hub < in_hub) {
+                ++out_position;
+            } else if (in_hub < out_hub) {
+                ++in_position;
+            } else {
+                const Weight weight = out_labels.weights[out_position] + in_labels.weights[in_position];
+                if (!result || weight < result->weight) {
+                    result = Meeting{weight, out_position, in_position};
+                }
+                ++out_position;
+                ++in_position;
+            }
+        }
+        return result;
+    }
+
+    // Позиция хаба в метке вершины; хаб обязан в ней быть
+    static size_t FindHub(const LabelSet& labels, VertexId vertex, uint32_t hub) {
+        const auto first = labels.hubs.begin() + labels.offsets[vertex];
+        const auto last = labels.hubs.begin() + labels.offsets[vertex + 1];
+        const auto it = std::lower_bound(first, last, hub);
+        if (it == last || *it != hub) {
+            throw std::logic_error("Hub labels are inconsistent");
+        }
+        return static_cast<size_t>(it - labels.hubs.begin());
+    }
+
+    // Метки при построении: по вершинам, хабы добавляются по возрастанию ранга
+    using BuildLabels = std::vector<std::vector<LabelEntry>>;
+
+    // Рабочие массивы обрезанных поисков, общие для всех корней
+    struct SearchState {
+        VertexMap<Weight> weights;
+        VertexMap<uint32_t> parent_edges;
+        MinHeap<QueueItem> queue;
+        // hub_weights[rank] - расстояние между корнем и хабом rank его метки, NO_WEIGHT - хаба в метке нет
+        std::vector<Weight> hub_weights;
+    };
+
+    // Обрезанный поиск от хаба rank: вершина, до которой уже известен не более длинный путь
+    // через хабы меньших рангов, не получает метку и не раскрывается дальше.
+    // forward - по исходящим рёбрам (пополняются входящие метки), иначе по входящим
+    void RunPrunedSearch(uint32_t rank, bool forward, const std::vector<std::vector<EdgeId>>& in_edges,
+                         BuildLabels& labels, const BuildLabels& opposite_labels, SearchState& state) const {
+        const VertexId root = order_[rank];
+        const size_t vertex_count = graph_.GetVertexCount();
+        auto& [weights, parent_edges, queue, hub_weights] = state;
+
+        // расстояния между корнем и хабами его собственной метки для быстрой проверки обрезки
+        for (const LabelEntry& entry : opposite_labels[root]) {
+            hub_weights[entry.hub] = entry.weight;
+        }
+
+        queue.Clear();
+        weights.Reset(vertex_count);
+        parent_edges.Reset(vertex_count);
+        weights.Set(root, ZERO_WEIGHT);
+        parent_edges.Set(root, NO_EDGE);
+        queue.Push({ZERO_WEIGHT, root});
+
+        while (!queue.Empty()) {
+            const auto [weight, vertex] = queue.Top();
+            queue.Pop();
+            if (weight > weights.Get(vertex)) {
+                continue;
+            }
+
+            if (vertex != root) {
+                bool covered = false;
+                for (const LabelEntry& entry : labels[vertex]) {
+                    if (hub_weights[entry.hub] != NO_WEIGHT && !(weight < hub_weights[entry.hub] + entry.weight)) {
+                        covered = true;
+                        break;
+                    }
+                }
+                if (covered) {
+                    continue;
+                }
+            }
+            labels[vertex].push_back(LabelEntry{rank, weight, parent_edges.Get(vertex)});
+
+            const auto relax = [&](EdgeId edge_id, VertexId next) {
+                const Weight next_weight = weight + graph_.GetEdge(edge_id).weight;
+                const Weight* known_weight = weights.Find(next);
+                if (!known_weight || next_weight < *known_weight) {
+                    weights.Set(next, next_weight);
+                    parent_edges.Set(next, static_cast<uint32_t>(edge_id));
+                    queue.Push({next_weight, next});
+                }
+            };
+            if (forward) {
+                for (const EdgeId edge_id : graph_.GetIncidentEdges(vertex)) {
+                    if (!graph_.IsEdgeRemoved(edge_id)) {
+                        relax(edge_id, graph_.GetEdge(edge_id).to);
+                    }
+                }
+            } else {
+                for (const EdgeId edge_id : in_edges[vertex]) {
+                    relax(edge_id, graph_.GetEdge(edge_id).from);
+                }
+            }
+        }
+
+        for (const LabelEntry& entry : opposite_labels[root]) {
+            hub_weights[entry.hub] = NO_WEIGHT;
+        }
+    }
+
+    // Порядок хабов: жадно по деревьям кратчайших путей от SAMPLE_ROOT_COUNT корней, прямых
+    // и обратных. Следующий хаб - вершина с наибольшим суммарным числом потомков в деревьях,
+    // после выбора её поддеревья из деревьев убираются: эти пути она уже покрывает.
+    // Вершины вне деревьев идут в конце по убыванию степени
+    std::vector<uint32_t> ComputeOrder(const std::vector<std::vector<EdgeId>>& in_edges,
+                                       const std::vector<size_t>& degrees) const {
+        const size_t vertex_count = graph_.GetVertexCount();
+
+        std::vector<VertexId> roots;
+        for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+            if (degrees[vertex] > 0) {
+                roots.push_back(vertex);
+            }
+        }
+        const size_t tree_root_count = std::min(roots.size(), SAMPLE_ROOT_COUNT);
+        const size_t tree_count = 2 * tree_root_count;
+
+        // деревья подряд: вершина v дерева t - ячейка t * vertex_count + v; дети вершины v -
+        // children[t * vertex_count + child_offsets[t * (vertex_count + 1) + v] ...]
+        std::vector<uint32_t> parents(tree_count * vertex_count, NO_VERTEX);
+        std::vector<uint32_t> descendants(tree_count * vertex_count, 0);
+        std::vector<uint32_t> child_offsets(tree_count * (vertex_count + 1), 0);
+        std::vector<uint32_t> children(tree_count * vertex_count, 0);
+        std::vector<size_t> coverage(vertex_count, 0);
+
+        std::vector<VertexId> settled;
+        VertexMap<Weight> weights;
+        MinHeap<QueueItem> queue;
+        for (size_t tree = 0; tree < tree_count; ++tree) {
+            const bool forward = tree < tree_root_count;
+            const VertexId root = roots[(tree % tree_root_count) * roots.size() / tree_root_count];
+            const size_t base = tree * vertex_count;
+
+            settled.clear();
+            weights.Reset(vertex_count);
+            queue.Clear();
+            weights.Set(root, ZERO_WEIGHT);
+            queue.Push({ZERO_WEIGHT, root});
+
+            while (!queue.Empty()) {
+                const auto [weight, vertex] = queue.Top();
+                queue.Pop();
+                if (weight > weights.Get(vertex)) {
+                    continue;
+                }
+                settled.push_back(vertex);
+
+                const auto relax = [&](EdgeId edge_id, VertexId next) {
+                    const Weight next_weight = weight + graph_.GetEdge(edge_id).weight;
+                    const Weight* known_weight = weights.Find(next);
+                    if (!known_weight || next_weight < *known_weight) {
+                        weights.Set(next, next_weight);
+                        parents[base + next] = static_cast<uint32_t>(vertex);
+                        queue.Push({next_weight, next});
+                    }
+                };
+                if (forward) {
+                    for (const EdgeId edge_id : graph_.GetIncidentEdges(vertex)) {
+                        if (!graph_.IsEdgeRemoved(edge_id)) {
+                            relax(edge_id, graph_.GetEdge(edge_id).to);
+                        }
+                    }
+                } else {
+                    for (const EdgeId edge_id : in_edges[vertex]) {
+                        relax(edge_id, graph_.GetEdge(edge_id).from);
+                    }
+                }
+            }
+            parents[base + root] = NO_VERTEX;
+
+            const size_t offsets_base = tree * (vertex_count + 1);
+            for (const VertexId vertex : settled) {
+                if (vertex != root) {
+                    ++child_offsets[offsets_base + parents[base + vertex] + 1];
+                }
+            }
+            for (size_t vertex = 0; vertex < vertex_count; ++vertex) {
+                child_offsets[offsets_base + vertex + 1] += child_offsets[offsets_base + vertex];
+            }
+            std::vector<uint32_t> next_slots(child_offsets.begin() + offsets_base,
+                                             child_offsets.begin() + offsets_base + vertex_count);
+            for (const VertexId vertex : settled) {
+                if (vertex != root) {
+                    children[base + next_slots[parents[base + vertex]]++] = static_cast<uint32_t>(vertex);
+                }
+            }
+
+            // вершины извлекаются раньше своих потомков, поэтому числа потомков
+            // накапливаются обратным проходом
+            for (auto it = settled.rbegin(); it != settled.rend(); ++it) {
+                const VertexId vertex = *it;
+                ++descendants[base + vertex];
+                if (vertex != root) {
+                    coverage[vertex] += descendants[base + vertex];
+                    descendants[base + parents[base + vertex]] += descendants[base + vertex];
+                }
+            }
+        }
+
+        std::vector<uint32_t> result;
+        result.reserve(vertex_count);
+        std::vector<bool> ordered(vertex_count, false);
+
+        using CoverageItem = std::pair<size_t, VertexId>;
+        std::priority_queue<CoverageItem> coverage_queue;
+        for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+            if (coverage[vertex] > 0) {
+                coverage_queue.push({coverage[vertex], vertex});
+            }
+        }
+
+        std::vector<uint32_t> stack;
+        while (!coverage_queue.empty()) {
+            const auto [vertex_coverage, vertex] = coverage_queue.top();
+            coverage_queue.pop();
+            if (ordered[vertex] || vertex_coverage != coverage[vertex]) {
+                // числа потомков только уменьшаются, устаревшая запись пропускается
+                if (!ordered[vertex] && coverage[vertex] > 0) {
+                    coverage_queue.push({coverage[vertex], vertex});
+                }
+                continue;
+            }
+            ordered[vertex] = true;
+            result.push_back(static_cast<uint32_t>(vertex));
+
+            for (size_t tree = 0; tree < tree_count; ++tree) {
+                const size_t base = tree * vertex_count;
+                const uint32_t removed_count = descendants[base + vertex];
+                if (removed_count == 0) {
+                    continue;
+                }
+                for (uint32_t ancestor = parents[base + vertex]; ancestor != NO_VERTEX; ancestor = parents[base + ancestor]) {
+                    descendants[base + ancestor] -= removed_count;
+                    if (parents[base + ancestor] != NO_VERTEX) {
+                        coverage[ancestor] -= removed_count;
+                    }
+                }
+                stack.assign(1, static_cast<uint32_t>(vertex));
+                while (!stack.empty()) {
+                    const uint32_t current = stack.back();
+                    stack.pop_back();
+                    if (parents[base + current] != NO_VERTEX) {
+                        coverage[current] -= descendants[base + current];
+                    }
+                    descendants[base + current] = 0;
+                    // уже убранные поддеревья пропускаются по нулевому числу потомков
+                    const size_t offsets_base = tree * (vertex_count + 1);
+                    for (uint32_t slot = child_offsets[offsets_base + current];
+                         slot < child_offsets[offsets_base + current + 1]; ++slot) {
+                        const uint32_t child = children[base + slot];
+                        if (descendants[base + child] > 0) {
+                            stack.push_back(child);
+                        }
+                    }
+                }
+            }
+        }
+
+        std::vector<uint32_t> rest;
+        for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+            if (!ordered[vertex]) {
+                rest.push_back(static_cast<uint32_t>(vertex));
+            }
+        }
+        std::stable_sort(rest.begin(), rest.end(), [&degrees](uint32_t lhs, uint32_t rhs) {
+            return degrees[lhs] > degrees[rhs];
+        });
+        result.insert(result.end(), rest.begin(), rest.end());
+
+        return result;
+    }
+
+    static LabelSet FlattenLabels(const BuildLabels& labels) {
+        size_t entry_count = 0;
+        for (const std::vector<LabelEntry>& label : labels) {
+            entry_count += label.size();
+        }
+        if (entry_count > std::numeric_limits<uint32_t>::max()) {
+            throw std::length_error("Too many label entries for 32-bit offsets");
+        }
+
+        LabelSet result;
+        result.offsets.reserve(labels.size() + 1);
+        result.hubs.reserve(entry_count);
+        result.weights.reserve(entry_count);
+        result.parent_edges.reserve(entry_count);
+        result.offsets.push_back(0);
+        for (const std::vector<LabelEntry>& label : labels) {
+            for (const LabelEntry& entry : label) {
+                result.hubs.push_back(entry.hub);
+                result.weights.push_back(entry.weight);
+                result.parent_edges.push_back(entry.parent_edge);
+            }
+            result.offsets.push_back(static_cast<uint32_t>(result.hubs.size()));
+        }
+        return result;
+    }
+
+    void BuildLabelSets() {
+        const size_t vertex_count = graph_.GetVertexCount();
+        if (vertex_count >= NO_VERTEX) {
+            throw std::length_error("Too many vertices for 32-bit hub ids");
+        }
+        if (graph_.GetEdgeCount() >= NO_EDGE) {
+            throw std::length_error("Too many edges for 32-bit edge ids");
+        }
+
+        std::vector<std::vector<EdgeId>> in_edges(vertex_count);
+        std::vector<size_t> degrees(vertex_count, 0);
+        for (EdgeId edge_id = 0; edge_id < graph_.GetEdgeCount(); ++edge_id) {
+            if (graph_.IsEdgeRemoved(edge_id)) {
+                continue;
+            }
+            const auto& edge = graph_.GetEdge(edge_id);
+            if (edge.weight < ZERO_WEIGHT) {
+                throw std::domain_error("Edges' weights should be non-negative");
+            }
+            in_edges[edge.to].push_back(edge_id);
+            ++degrees[edge.from];
+            ++degrees[edge.to];
+        }
+
+        order_ = ComputeOrder(in_edges, degrees);
+
+        BuildLabels out_labels(vertex_count);
+        BuildLabels in_labels(vertex_count);
+        SearchState state;
+        state.hub_weights.assign(vertex_count, NO_WEIGHT);
+        for (uint32_t rank = 0; rank < vertex_count; ++rank) {
+            RunPrunedSearch(rank, true, in_edges, in_labels, out_labels, state);
+            RunPrunedSearch(rank, false, in_edges, out_labels, in_labels, state);
+        }
+
+        out_labels_ = FlattenLabels(out_labels);
+        in_labels_ = FlattenLabels(in_labels);
+    }
+
+    static bool IsConsistent(const LabelSet& labels, size_t vertex_count) {
+        return labels.offsets.size() == vertex_count + 1
+               && labels.offsets.back() == labels.hubs.size()
+               && labels.weights.size() == labels.hubs.size()
+               && labels.parent_edges.size() == labels.hubs.size();
+    }
+
+    // Число корней деревьев кратчайших путей, по которым выбирается порядок хабов
+    static constexpr size_t SAMPLE_ROOT_COUNT = 128;
+    static constexpr uint32_t NO_VERTEX = std::numeric_limits<uint32_t>::max();
+
+    static constexpr Weight ZERO_WEIGHT{};
+    static constexpr Weight NO_WEIGHT = std::numeric_limits<Weight>::max();
+    const Graph& graph_;
+    std::vector<uint32_t> order_;
+    LabelSet out_labels_;
+    LabelSet in_labels_;
+};
+
+template <typename Weight>
+HubLabels<Weight>::HubLabels(const Graph& graph)
+    : graph_(graph)
+{
+    BuildLabelSets();
+}
+
+template <typename Weight>
+HubLabels<Weight>::HubLabels(const Graph& graph, std::vector<uint32_t> order, LabelSet out_labels, LabelSet in_labels)
+    : graph_(graph)
+    , order_(std::move(order))
+    , out_labels_(std::move(out_labels))
+    , in_labels_(std::move(in_labels))
+{
+    if (order_.size() != graph.GetVertexCount()
+        || !IsConsistent(out_labels_, graph.GetVertexCount())
+        || !IsConsistent(in_labels_, graph.GetVertexCount())) {
+        throw std::invalid_argument("Hub labels don't match the graph");
+    }
+}
+
+template <typename Weight>
+std::optional<typename HubLabels<Weight>::RouteInfo> HubLabels<Weight>::BuildRoute(VertexId from, VertexId to) const {
+    const size_t vertex_count = graph_.GetVertexCount();
+    if (from >= vertex_count || to >= vertex_count) {
+        throw std::out_of_range("Vertex is out of range");
+    }
+
+    const std::optional<Meeting> meeting = MergeLabels(out_labels_, from, in_labels_, to);
+    if (!meeting) {
+        return std::nullopt;
+    }
+    const uint32_t hub = out_labels_.hubs[meeting->out_position];
+
+    // от from к хабу по исходящим меткам, затем от to назад к хабу по входящим
+    std::vector<EdgeId> edges;
+    for (uint32_t edge_id = out_labels_.parent_edges[meeting->out_position]; edge_id != NO_EDGE;) {
+        edges.push_back(edge_id);
+        edge_id = out_labels_.parent_edges[FindHub(out_labels_, graph_.GetEdge(edge_id).to, hub)];
+    }
+    const size_t forward_size = edges.size();
+    for (uint32_t edge_id = in_labels_.parent_edges[meeting->in_position]; edge_id != NO_EDGE;) {
+        edges.push_back(edge_id);
+        edge_id = in_labels_.parent_edges[FindHub(in_labels_, graph_.GetEdge(edge_id).from, hub)];
+    }
+    std::reverse(edges.begin() + forward_size, edges.end());
+
+    return RouteInfo{meeting->weight, std::move(edges)};
+}
+
+template <typename Weight>
+std::vector<std::optional<Weight>> HubLabels<Weight>::BuildWeights(VertexId from, const std::vector<VertexId>& targets) const {
+    const size_t vertex_count = graph_.GetVertexCount();
+    if (from >= vertex_count) {
+        throw std::out_of_range("Vertex is out of range");
+    }
+
+    std::vector<std::optional<Weight>> result;
+    result.reserve(targets.size());
+    for (const VertexId to : targets) {
+        if (to >= vertex_count) {
+            throw std::out_of_range("Vertex is out of range");
+        }
+        const std::optional<Meeting> meeting = MergeLabels(out_labels_, from, in_labels_, to);
+        result.push_back(meeting ? std::optional<Weight>(meeting->weight) : std::nullopt);
+    }
+    return result;
+}
+
+}  // namespace graph
@@ -12,6 +12,7 @@
 #include <iomanip>
 #include <unordered_set>
 #include <algorithm>
+#include <stdexcept>
 
 
 namespace transport_catalogue {
@@ -27,6 +28,20 @@ void FillInTheSerializationSettings(json::Node& node, serialization::Serializati
     }
 }
 
+void FillInTheExecutionSettings(const json::Node& node, ExecutionSettings& execution_settings) {
+    if (node.IsDict()) {
+        const json::Dict& execution_settings_map = node.AsDict();
+        
+        if (execution_settings_map.count("thread_count") != 0) {
+            const int thread_count = execution_settings_map.at("thread_count").AsInt();
+            if (thread_count < 0) {
+                throw std::invalid_argument("thread_count should not be negative: " + std::to_string(thread_count));
+            }
+            execution_settings.thread_count = thread_count;
+        }
+    }
+}
+
 Stop FillInTheStop(json::Node& node) {
     Stop result;
     json::Dict dict = node.AsDict();
@@ -182,12 +197,86 @@ void FillInTheRenderSettings(const json::Node& node, renderer::RenderSettings& r
     }
 }
 
+router::RouterType ParsingRouterType(const json::Node& node) {
+    const std::string& router_type = node.AsString();
+    
+    if (router_type == "all_pairs") {
+        return router::RouterType::ALL_PAIRS;
+    } else if (router_type == "dijkstra") {
+        return router::RouterType::DIJKSTRA;
+    } else if (router_type == "contraction_hierarchy") {
+        return router::RouterType::CONTRACTION_HIERARCHY;
+    } else if (router_type == "astar") {
+        return router::RouterType::ASTAR;
+    } else if (router_type == "alt") {
+        return router::RouterType::ALT;
+    } else if (router_type == "raptor") {
+        return router::RouterType::RAPTOR;
+    } else if (router_type == "hub_labels") {
+        return router::RouterType::HUB_LABELS;
+    }
+    
+    throw std::invalid_argument("unknown router_type: " + router_type);
+}
+
+router::GraphModel ParsingGraphModel(const json::Node& node) {
+    const std::string& graph_model = node.AsString();
+    
+    if (graph_model == "complete") {
+        return router::GraphModel::COMPLETE;
+    } else if (graph_model == "route_pattern") {
+        return router::GraphModel::ROUTE_PATTERN;
+    } else if (graph_model == "collapsed") {
+        return router::GraphModel::COLLAPSED;
+    }
+    
+    throw std::invalid_argument("unknown graph_model: " + graph_model);
+}
+
 void FillInTheRoutingSettings(const json::Node& node, router::RoutingSettings& routing_settings) {
     if (node.IsDict()) {
         json::Dict routing_settings_map = node.AsDict();
         
         routing_settings.bus_velocity = routing_settings_map.at("bus_velocity").AsDouble();
         routing_settings.bus_wait_time = routing_settings_map.at("bus_wait_time").AsDouble();
+        
+        if (routing_settings_map.count("router_type") != 0) {
+            routing_settings.router_type = ParsingRouterType(routing_settings_map.at("router_type"));
+        }
+        if (routing_settings_map.count("graph_model") != 0) {
+            routing_settings.graph_model = ParsingGraphModel(routing_settings_map.at("graph_model"));
+        }
+        if (routing_settings_map.count("max_transfers") != 0) {
+            const int max_transfers = routing_settings_map.at("max_transfers").AsInt();
+            if (max_transfers < 0) {
+                throw std::invalid_argument("max_transfers should not be negative: " + std::to_string(max_transfers));
+            }
+            routing_settings.max_transfers = max_transfers;
+        }
+        if (routing_settings_map.count("route_cache_capacity") != 0) {
+            const int route_cache_capacity = routing_settings_map.at("route_cache_capacity").AsInt();
+            if (route_cache_capacity < 0) {
+                throw std::invalid_argument("route_cache_capacity should not be negative: " + std::to_string(route_cache_capacity));
+            }
+            routing_settings.route_cache_capacity = route_cache_capacity;
+        }
+        if (routing_settings_map.count("fixed_point_weights") != 0) {
+            routing_settings.fixed_point_weights = routing_settings_map.at("fixed_point_weights").AsBool();
+        }
+        if (routing_settings_map.count("walk_radius") != 0) {
+            const double walk_radius = routing_settings_map.at("walk_radius").AsDouble();
+            if (walk_radius < 0) {
+                throw std::invalid_argument("walk_radius should not be negative: " + std::to_string(walk_radius));
+            }
+            routing_settings.walk_radius = walk_radius;
+        }
+        if (routing_settings_map.count("walk_velocity") != 0) {
+            const double walk_velocity = routing_settings_map.at("walk_velocity").AsDouble();
+            if (walk_velocity <= 0) {
+                throw std::invalid_argument("walk_velocity should be positive: " + std::to_string(walk_velocity));
+            }
+            routing_settings.walk_velocity = walk_velocity;
+        }
     }
 }
 
@@ -216,6 +305,35 @@ void ParsingRequest(const json::Node& node, std::vector<StatRequest>& stat_reque
                 buffer_request.name = "";
                 buffer_request.from = buffer_dict.at("from").AsString();
                 buffer_request.to = buffer_dict.at("to").AsString();
+                buffer_request.pareto = buffer_dict.count("pareto") != 0
+                                        && buffer_dict.at("pareto").AsBool();
+            } else if (buffer_request.type == "Matrix") {
+                buffer_request.name = "";
+                buffer_request.from = "";
+                buffer_request.to = "";
+                buffer_request.from_list.clear();
+                buffer_request.to_list.clear();
+                for (const json::Node& stop : buffer_dict.at("from").AsArray()) {
+                    buffer_request.from_list.push_back(stop.AsString());
+                }
+                for (const json::Node& stop : buffer_dict.at("to").AsArray()) {
+                    buffer_request.to_list.push_back(stop.AsString());
+                }
+            } else if (buffer_request.type == "ArriveBy") {
+                buffer_request.name = "";
+                buffer_request.to = buffer_dict.at("to").AsString();
+                buffer_request.arrive_by = buffer_dict.at("arrive_by").AsDouble();
+                buffer_request.from_list.clear();
+                for (const json::Node& stop : buffer_dict.at("from").AsArray()) {
+                    buffer_request.from_list.push_back(stop.AsString());
+                }
+            } else if (buffer_request.type == "Isochrone") {
+                buffer_request.name = "";
+                buffer_request.from = buffer_dict.at("from").AsString();
+                buffer_request.to = "";
+                buffer_request.max_time = buffer_dict.at("max_time").AsDouble();
+                buffer_request.render_hull = buffer_dict.count("render_hull") != 0
+                                             && buffer_dict.at("render_hull").AsBool();
             } else if (buffer_request.type == "Map") {
                 buffer_request.name = "";
                 buffer_request.from = "";
@@ -250,6 +368,7 @@ void SplittingDocumentMakeBase(json::Document& document_in,
 
 void SplittingDocumentProcessRequests(json::Document& document_in,
                                       serialization::SerializationSettings& serialization_settings,
+                                      ExecutionSettings& execution_settings,
                                       std::vector<StatRequest>& stat_requests) {
     json::Node node = document_in.GetRoot();
     
@@ -258,6 +377,9 @@ void SplittingDocumentProcessRequests(json::Document& document_in,
         json::Dict dict = node.AsDict();
         
         reader::FillInTheSerializationSettings(dict.at("serialization_settings"), serialization_settings);
+        if (dict.count("execution_settings") != 0) {
+            reader::FillInTheExecutionSettings(dict.at("execution_settings"), execution_settings);
+        }
         
         request::ParsingRequest(dict.at("stat_requests"), stat_requests);
         
@@ -17,6 +17,7 @@ namespace handling_json {
 namespace reader {
 
 void FillInTheSerializationSettings(json::Node& node, serialization::SerializationSettings& serialization_settings);
+void FillInTheExecutionSettings(const json::Node& node, ExecutionSettings& execution_settings);
 
 Stop FillInTheStop(json::Node& node);
 void FillInTheDistances (json::Node& node, TransportCatalogue& tc);
@@ -26,6 +27,8 @@ void FillInTheData(const json::Node& node, TransportCatalogue& tc);
 svg::Color ParsingCollor(const json::Node& node);
 
 void FillInTheRenderSettings(const json::Node& node, renderer::RenderSettings& render_settings);
+router::RouterType ParsingRouterType(const json::Node& node);
+router::GraphModel ParsingGraphModel(const json::Node& node);
 void FillInTheRoutingSettings(const json::Node& node, router::RoutingSettings& routing_settings);
 
 } //end namespace reader
@@ -43,6 +46,7 @@ void SplittingDocumentMakeBase(json::Document& document_in,
                                serialization::SerializationSettings& serialization_settings);
 void SplittingDocumentProcessRequests(json::Document& document_in,
                                       serialization::SerializationSettings& serialization_settings,
+                                      ExecutionSettings& execution_settings,
                                       std::vector<StatRequest>& stat_requests);
 
 } //end namespace handling_json
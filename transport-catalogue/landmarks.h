@@ -0,0 +1,164 @@
+#pragma once
+
+#include "graph.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+// Ориентиры для поиска ALT (A*, landmarks, triangle inequality): расстояния от каждого
+// ориентира до всех вершин и от всех вершин до ориентира. По неравенству треугольника
+// из них получается допустимая нижняя оценка веса пути между любыми двумя вершинами
+template <typename Weight>
+class Landmarks {
+private:
+    using Graph = DirectedWeightedGraph<Weight>;
+
+public:
+    static constexpr size_t DEFAULT_LANDMARK_COUNT = 8;
+
+    explicit Landmarks(const Graph& graph, size_t landmark_count = DEFAULT_LANDMARK_COUNT);
+
+    Weight GetLowerBound(VertexId from, VertexId to) const;
+
+    const std::vector<VertexId>& GetLandmarks() const {
+        return landmarks_;
+    }
+
+private:
+    static constexpr Weight ZERO_WEIGHT{};
+    static constexpr Weight NO_DISTANCE = std::numeric_limits<Weight>::max();
+
+    using QueueItem = std::pair<Weight, VertexId>;
+    using Queue = std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>>;
+
+    // Расстояния от source до всех вершин; reverse - поиск по развёрнутым рёбрам
+    std::vector<Weight> ComputeDistances(VertexId source, bool reverse) const;
+
+    const Graph& graph_;
+    std::vector<std::vector<EdgeId>> incoming_edges_;
+    std::vector<VertexId> landmarks_;
+
+    // [landmark_index * vertex_count + vertex]
+    std::vector<Weight> distances_from_landmarks_;
+    std::vector<Weight> distances_to_landmarks_;
+};
+
+template <typename Weight>
+Landmarks<Weight>::Landmarks(const Graph& graph, size_t landmark_count)
+    : graph_(graph)
+    , incoming_edges_(graph.GetVertexCount())
+{
+    const size_t vertex_count = graph.GetVertexCount();
+    for (EdgeId edge_id = 0; edge_id < graph.GetEdgeCount(); ++edge_id) {
+        if (graph.IsEdgeRemoved(edge_id)) {
+            continue;
+        }
+        const auto& edge = graph.GetEdge(edge_id);
+        if (edge.weight < ZERO_WEIGHT) {
+            throw std::domain_error("Edges' weights should be non-negative");
+        }
+        incoming_edges_[edge.to].push_back(edge_id);
+    }
+
+    // Первый ориентир - вершина с наибольшим числом исходящих рёбер (скорее всего, в самой
+    // большой компоненте), следующий - самая далёкая достижимая вершина от уже выбранных
+    std::optional<VertexId> next_landmark;
+    std::ptrdiff_t max_degree = 0;
+    for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+        const auto edges = graph.GetIncidentEdges(vertex);
+        const std::ptrdiff_t degree = std::distance(edges.begin(), edges.end());
+        if (!next_landmark || degree > max_degree) {
+            next_landmark = vertex;
+            max_degree = degree;
+        }
+    }
+
+    std::vector<Weight> nearest_landmark_distances(vertex_count, NO_DISTANCE);
+    while (next_landmark && landmarks_.size() < landmark_count) {
+        landmarks_.push_back(*next_landmark);
+        const std::vector<Weight> from_landmark = ComputeDistances(*next_landmark, false);
+        const std::vector<Weight> to_landmark = ComputeDistances(*next_landmark, true);
+        distances_from_landmarks_.insert(distances_from_landmarks_.end(), from_landmark.begin(), from_landmark.end());
+        distances_to_landmarks_.insert(distances_to_landmarks_.end(), to_landmark.begin(), to_landmark.end());
+
+        next_landmark.reset();
+        for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+            nearest_landmark_distances[vertex] = std::min(nearest_landmark_distances[vertex], from_landmark[vertex]);
+            const Weight distance = nearest_landmark_distances[vertex];
+            if (distance != NO_DISTANCE && distance > ZERO_WEIGHT
+                && (!next_landmark || distance > nearest_landmark_distances[*next_landmark])) {
+                next_landmark = vertex;
+            }
+        }
+    }
+}
+
+template <typename Weight>
+Weight Landmarks<Weight>::GetLowerBound(VertexId from, VertexId to) const {
+    const size_t vertex_count = graph_.GetVertexCount();
+    Weight result = ZERO_WEIGHT;
+
+    for (size_t index = 0; index < landmarks_.size(); ++index) {
+        const Weight* from_landmark = distances_from_landmarks_.data() + index * vertex_count;
+        const Weight* to_landmark = distances_to_landmarks_.data() + index * vertex_count;
+
+        // d(L, to) <= d(L, from) + d(from, to)
+        if (from_landmark[from] != NO_DISTANCE && from_landmark[to] != NO_DISTANCE) {
+            result = std::max(result, from_landmark[to] - from_landmark[from]);
+        }
+        // d(from, L) <= d(from, to) + d(to, L)
+        if (to_landmark[from] != NO_DISTANCE && to_landmark[to] != NO_DISTANCE) {
+            result = std::max(result, to_landmark[from] - to_landmark[to]);
+        }
+    }
+    return result;
+}
+
+template <typename Weight>
+std::vector<Weight> Landmarks<Weight>::ComputeDistances(VertexId source, bool reverse) const {
+    std::vector<Weight> result(graph_.GetVertexCount(), NO_DISTANCE);
+    Queue queue;
+    result[source] = ZERO_WEIGHT;
+    queue.push({ZERO_WEIGHT, source});
+
+    while (!queue.empty()) {
+        const Weight weight = queue.top().first;
+        const VertexId vertex = queue.top().second;
+        queue.pop();
+        if (weight > result[vertex]) {
+            continue;
+        }
+
+        auto relax = [&](VertexId neighbor, Weight edge_weight) {
+            const Weight candidate_weight = weight + edge_weight;
+            if (candidate_weight < result[neighbor]) {
+                result[neighbor] = candidate_weight;
+                queue.push({candidate_weight, neighbor});
+            }
+        };
+        if (reverse) {
+            for (const EdgeId edge_id : incoming_edges_[vertex]) {
+                const auto& edge = graph_.GetEdge(edge_id);
+                relax(edge.from, edge.weight);
+            }
+        } else {
+            for (const EdgeId edge_id : graph_.GetIncidentEdges(vertex)) {
+                const auto& edge = graph_.GetEdge(edge_id);
+                relax(edge.to, edge.weight);
+            }
+        }
+    }
+    return result;
+}
+
+}  // namespace graph
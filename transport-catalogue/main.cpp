@@ -5,6 +5,7 @@
 
 #include <fstream>
 #include <iostream>
+#include <memory>
 #include <string_view>
 
 using namespace std::literals;
@@ -41,35 +42,43 @@ int main(int argc, char* argv[]) {
                                                                       TCatalogue,
                                                                       serialization_settings);
         
+        transport_catalogue::router::TransportRouter transport_router(TCatalogue, routing_setings);
+        
         std::ofstream output(serialization_settings.file_name, std::ios::binary);
         transport_catalogue::serialization::Serialization(TCatalogue,
                                                           render_settings,
                                                           routing_setings,
+                                                          transport_router,
                                                           output);
 
     } else if (mode == "process_requests"sv) {
 
         // process requests here
         std::vector<transport_catalogue::StatRequest> stat_requests;
+        transport_catalogue::ExecutionSettings execution_settings;
         
         transport_catalogue::handling_json::SplittingDocumentProcessRequests(input_data,
                                                                              serialization_settings,
+                                                                             execution_settings,
                                                                              stat_requests);
         
+        std::unique_ptr<transport_catalogue::router::LazyTransportRouter> transport_router;
+        
         std::ifstream input(serialization_settings.file_name, std::ios::binary);
         transport_catalogue::serialization::Deserialization(TCatalogue,
                                                             render_settings,
                                                             routing_setings,
+                                                            transport_router,
                                                             input);
         
         json::Document result_data;
         
         transport_catalogue::renderer::MapRenderer map_renderer(render_settings);
-        transport_catalogue::router::TransportRouter transport_router(TCatalogue, routing_setings);
     
         transport_catalogue::request_handler::RequestHandler request_handler(TCatalogue, 
                                                                              map_renderer, 
-                                                                             transport_router);
+                                                                             *transport_router,
+                                                                             execution_settings.thread_count);
         
         result_data = request_handler.ReplyToTheRequest(stat_requests);
     
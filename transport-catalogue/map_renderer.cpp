@@ -341,5 +341,38 @@ void MapRenderer::RenderMap(std::ostream& out, TransportCatalogue& db) const {
     document.Render(out);
 }
 
+void MapRenderer::RenderIsochrone(std::ostream& out,
+                                  const std::vector<geo::Coordinates>& reachable_coordinates,
+                                  TransportCatalogue& db) const {
+    svg::Document document;
+    SphereProjector sphere_projector = GetSphereProjector(GetStopsCoordinates(db));
+    
+    const std::vector<geo::Coordinates> hull = geo::ComputeConvexHull(reachable_coordinates);
+    
+    if (!hull.empty()) {
+        svg::Polyline hull_line;
+        
+        for (const geo::Coordinates& point : hull) {
+            hull_line.AddPoint(sphere_projector(point));
+        }
+        hull_line.AddPoint(sphere_projector(hull.front()));
+        
+        hull_line.SetFillColor(render_settings_.underlayer_color_);
+        hull_line.SetStrokeColor(color_palette_size_ > 0 ? render_settings_.color_palette_[0] : svg::Color{"black"});
+        hull_line.SetStrokeWidth(render_settings_.underlayer_width_);
+        hull_line.SetStrokeLineCap(svg::StrokeLineCap::ROUND);
+        hull_line.SetStrokeLineJoin(svg::StrokeLineJoin::ROUND);
+        document.Add(hull_line);
+    }
+    
+    svg::Circle circle;
+    for (const geo::Coordinates& point : reachable_coordinates) {
+        SetStopsCirclesParameters(circle, sphere_projector(point));
+        document.Add(circle);
+    }
+    
+    document.Render(out);
+}
+
 } //end namespace renderer
 } //end namespace transport_catalogue
\ No newline at end of file
@@ -93,6 +93,11 @@ public:
                             TransportCatalogue& db) const;
     
     void RenderMap(std::ostream& out, TransportCatalogue& db) const;
+    // Выпуклая оболочка достижимых остановок и сами остановки в проекции карты,
+    // чтобы изображение накладывалось на результат RenderMap
+    void RenderIsochrone(std::ostream& out,
+                         const std::vector<geo::Coordinates>& reachable_coordinates,
+                         TransportCatalogue& db) const;
     
 private:
     RenderSettings render_settings_;
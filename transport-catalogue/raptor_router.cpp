@@ -0,0 +1,323 @@
+#include "raptor_router.h"
+
+#include "geo.h"
+
+#include <algorithm>
+#include <functional>
+
+namespace transport_catalogue {
+namespace router {
+
+RaptorRouter::RaptorRouter(const TransportCatalogue& db,
+                           const std::vector<const Bus*>& buses,
+                           double bus_wait_time,
+                           double bus_velocity,
+                           std::optional<int> max_transfers,
+                           const std::vector<std::pair<size_t, size_t>>& walk_pairs,
+                           double walk_velocity)
+: bus_wait_time_(bus_wait_time)
+, max_transfers_(max_transfers)
+{
+    for (const Stop& stop : db.GetStops()) {
+        stops_.push_back(&stop);
+    }
+    
+    std::vector<uint32_t> stop_route_counts(stops_.size(), 0);
+    route_offsets_.push_back(0);
+    for (const Bus* bus : buses) {
+        for (auto it = bus->stops.begin(); it != bus->stops.end(); ++it) {
+            const uint32_t stop_index = static_cast<uint32_t>((*it)->id);
+            
+            route_times_.push_back(it == bus->stops.begin()
+                                   ? 0
+                                   : route_times_.back() + db.GetDistanceBetweenStops(*prev(it), *it) / bus_velocity);
+            route_stops_.push_back(stop_index);
+            ++stop_route_counts[stop_index];
+        }
+        route_offsets_.push_back(static_cast<uint32_t>(route_stops_.size()));
+        route_buses_.push_back(bus);
+    }
+    
+    stop_route_offsets_.assign(stops_.size() + 1, 0);
+    for (size_t stop_index = 0; stop_index < stops_.size(); ++stop_index) {
+        stop_route_offsets_[stop_index + 1] = stop_route_offsets_[stop_index] + stop_route_counts[stop_index];
+    }
+    
+    stop_routes_.resize(route_stops_.size());
+    stop_positions_.resize(route_stops_.size());
+    std::vector<uint32_t> next_slots(stop_route_offsets_.begin(), std::prev(stop_route_offsets_.end()));
+    for (uint32_t route = 0; route < route_buses_.size(); ++route) {
+        for (uint32_t position = route_offsets_[route]; position < route_offsets_[route + 1]; ++position) {
+            const uint32_t slot = next_slots[route_stops_[position]]++;
+            stop_routes_[slot] = route;
+            stop_positions_[slot] = position;
+        }
+    }
+    
+    if (walk_pairs.empty()) {
+        return;
+    }
+    
+    footpath_offsets_.assign(stops_.size() + 1, 0);
+    for (const auto& [first, second] : walk_pairs) {
+        ++footpath_offsets_[first + 1];
+        ++footpath_offsets_[second + 1];
+    }
+    for (size_t stop_index = 0; stop_index < stops_.size(); ++stop_index) {
+        footpath_offsets_[stop_index + 1] += footpath_offsets_[stop_index];
+    }
+    
+    footpath_stops_.resize(2 * walk_pairs.size());
+    footpath_times_.resize(2 * walk_pairs.size());
+    std::vector<uint32_t> next_footpaths(footpath_offsets_.begin(), std::prev(footpath_offsets_.end()));
+    for (const auto& [first, second] : walk_pairs) {
+        const double time = geo::ComputeDistance(stops_[first]->coord, stops_[second]->coord) / walk_velocity;
+        
+        const uint32_t forward = next_footpaths[first]++;
+        footpath_stops_[forward] = static_cast<uint32_t>(second);
+        footpath_times_[forward] = time;
+        
+        const uint32_t backward = next_footpaths[second]++;
+        footpath_stops_[backward] = static_cast<uint32_t>(first);
+        footpath_times_[backward] = time;
+    }
+}
+
+RaptorRouter::SearchScratch& RaptorRouter::GetScratch() {
+    static thread_local SearchScratch scratch;
+    return scratch;
+}
+
+void RaptorRouter::RunRounds(uint32_t source, std::optional<uint32_t> target, double max_time, SearchScratch& scratch,
+                             std::vector<TargetArrival>* target_arrivals) const {
+    auto& arrivals = scratch.arrivals;
+    auto& stop_labels = scratch.stop_labels;
+    auto& labels = scratch.labels;
+    auto& previous_arrivals = scratch.previous_arrivals;
+    auto& previous_stop_labels = scratch.previous_stop_labels;
+    auto& marked = scratch.marked;
+    auto& marked_stops = scratch.marked_stops;
+    auto& route_starts = scratch.route_starts;
+    auto& queued_routes = scratch.queued_routes;
+    
+    arrivals.assign(stops_.size(), NO_TIME);
+    stop_labels.assign(stops_.size(), NO_LABEL);
+    labels.clear();
+    marked.assign(stops_.size(), false);
+    marked_stops.assign(1, source);
+    route_starts.assign(route_buses_.size(), NO_POSITION);
+    queued_routes.clear();
+    
+    arrivals[source] = 0;
+    
+    // маршруты только пешком - без поездок
+    RelaxFootpaths(target, max_time, scratch);
+    if (target_arrivals && target && *target != source && arrivals[*target] != NO_TIME) {
+        target_arrivals->push_back(TargetArrival{arrivals[*target], stop_labels[*target]});
+    }
+    
+    for (int round = 0; !marked_stops.empty() && (!max_transfers_ || round <= *max_transfers_); ++round) {
+        previous_arrivals = arrivals;
+        previous_stop_labels = stop_labels;
+        
+        // каждый маршрут через отмеченные остановки просматривается с самой ранней из них
+        for (const uint32_t stop_index : marked_stops) {
+            marked[stop_index] = false;
+            for (uint32_t slot = stop_route_offsets_[stop_index]; slot < stop_route_offsets_[stop_index + 1]; ++slot) {
+                const uint32_t route = stop_routes_[slot];
+                if (route_starts[route] == NO_POSITION) {
+                    queued_routes.push_back(route);
+                    route_starts[route] = stop_positions_[slot];
+                } else {
+                    route_starts[route] = std::min(route_starts[route], stop_positions_[slot]);
+                }
+            }
+        }
+        marked_stops.clear();
+        
+        for (const uint32_t route : queued_routes) {
+            std::optional<uint32_t> board_position;
+            double board_time = NO_TIME;
+            uint32_t board_label = NO_LABEL;
+            
+            for (uint32_t position = route_starts[route]; position < route_offsets_[route + 1]; ++position) {
+                const uint32_t stop_index = route_stops_[position];
+                double time = NO_TIME;
+                
+                if (board_position) {
+                    time = board_time + (route_times_[position] - route_times_[*board_position]);
+                    const double bound = target ? std::min(arrivals[stop_index], arrivals[*target]) : arrivals[stop_index];
+                    if (time < bound && time <= max_time) {
+                        arrivals[stop_index] = time;
+                        labels.push_back(Label{board_label, route, *board_position, position});
+                        stop_labels[stop_index] = static_cast<uint32_t>(labels.size() - 1);
+                        if (!marked[stop_index]) {
+                            marked[stop_index] = true;
+                            marked_stops.push_back(stop_index);
+                        }
+                    }
+                }
+                
+                // пересесть на этот автобус здесь выгоднее, чем ехать в нём дальше
+                if (previous_arrivals[stop_index] + bus_wait_time_ < time) {
+                    board_position = position;
+                    board_time = previous_arrivals[stop_index] + bus_wait_time_;
+                    board_label = previous_stop_labels[stop_index];
+                }
+            }
+            route_starts[route] = NO_POSITION;
+        }
+        queued_routes.clear();
+        
+        RelaxFootpaths(target, max_time, scratch);
+        
+        if (target_arrivals && target && arrivals[*target] < previous_arrivals[*target]) {
+            target_arrivals->push_back(TargetArrival{arrivals[*target], stop_labels[*target]});
+        }
+    }
+}
+
+void RaptorRouter::RelaxFootpaths(std::optional<uint32_t> target, double max_time, SearchScratch& scratch) const {
+    if (footpath_offsets_.empty()) {
+        return;
+    }
+    
+    auto& arrivals = scratch.arrivals;
+    auto& stop_labels = scratch.stop_labels;
+    auto& labels = scratch.labels;
+    auto& marked = scratch.marked;
+    auto& marked_stops = scratch.marked_stops;
+    auto& queue = scratch.footpath_queue;
+    
+    queue.clear();
+    for (const uint32_t stop_index : marked_stops) {
+        queue.emplace_back(arrivals[stop_index], stop_index);
+    }
+    std::make_heap(queue.begin(), queue.end(), std::greater<>{});
+    
+    while (!queue.empty()) {
+        std::pop_heap(queue.begin(), queue.end(), std::greater<>{});
+        const auto [time, stop_index] = queue.back();
+        queue.pop_back();
+        if (time > arrivals[stop_index]) {
+            continue;
+        }
+        
+        for (uint32_t footpath = footpath_offsets_[stop_index]; footpath < footpath_offsets_[stop_index + 1]; ++footpath) {
+            const uint32_t next_stop = footpath_stops_[footpath];
+            const double next_time = time + footpath_times_[footpath];
+            const double bound = target ? std::min(arrivals[next_stop], arrivals[*target]) : arrivals[next_stop];
+            if (next_time < bound && next_time <= max_time) {
+                arrivals[next_stop] = next_time;
+                labels.push_back(Label{stop_labels[stop_index], WALK_ROUTE, stop_index, footpath});
+                stop_labels[next_stop] = static_cast<uint32_t>(labels.size() - 1);
+                if (!marked[next_stop]) {
+                    marked[next_stop] = true;
+                    marked_stops.push_back(next_stop);
+                }
+                queue.emplace_back(next_time, next_stop);
+                std::push_heap(queue.begin(), queue.end(), std::greater<>{});
+            }
+        }
+    }
+}
+
+RaptorRouter::Journey RaptorRouter::MakeJourney(double time, uint32_t label_index, const std::vector<Label>& labels) const {
+    Journey result;
+    result.time = time;
+    for (; label_index != NO_LABEL; label_index = labels[label_index].parent) {
+        const Label& label = labels[label_index];
+        if (label.route == WALK_ROUTE) {
+            result.legs.push_back(Leg{stops_[label.board_position],
+                                      nullptr,
+                                      footpath_times_[label.alight_position],
+                                      0,
+                                      stops_[footpath_stops_[label.alight_position]]});
+            continue;
+        }
+        result.legs.push_back(Leg{stops_[route_stops_[label.board_position]],
+                                  route_buses_[label.route],
+                                  route_times_[label.alight_position] - route_times_[label.board_position],
+                                  static_cast<int>(label.alight_position - label.board_position),
+                                  stops_[route_stops_[label.alight_position]]});
+    }
+    std::reverse(result.legs.begin(), result.legs.end());
+    
+    return result;
+}
+
+std::optional<RaptorRouter::Journey> RaptorRouter::BuildRoute(const Stop* from, const Stop* to) const {
+    const uint32_t source = static_cast<uint32_t>(from->id);
+    const uint32_t target = static_cast<uint32_t>(to->id);
+    
+    if (source == target) {
+        return Journey{};
+    }
+    
+    SearchScratch& scratch = GetScratch();
+    RunRounds(source, target, NO_TIME, scratch);
+    
+    if (scratch.arrivals[target] == NO_TIME) {
+        return std::nullopt;
+    }
+    
+    return MakeJourney(scratch.arrivals[target], scratch.stop_labels[target], scratch.labels);
+}
+
+std::vector<RaptorRouter::Journey> RaptorRouter::BuildParetoRoutes(const Stop* from, const Stop* to) const {
+    const uint32_t source = static_cast<uint32_t>(from->id);
+    const uint32_t target = static_cast<uint32_t>(to->id);
+    
+    if (source == target) {
+        return {Journey{}};
+    }
+    
+    SearchScratch& scratch = GetScratch();
+    std::vector<TargetArrival> target_arrivals;
+    RunRounds(source, target, NO_TIME, scratch, &target_arrivals);
+    
+    // метки не перезаписываются, поэтому цепочки прошлых раундов остаются целыми
+    std::vector<Journey> result;
+    result.reserve(target_arrivals.size());
+    for (const TargetArrival& target_arrival : target_arrivals) {
+        result.push_back(MakeJourney(target_arrival.time, target_arrival.label, scratch.labels));
+    }
+    
+    return result;
+}
+
+std::vector<std::optional<double>> RaptorRouter::BuildTimes(const Stop* from,
+                                                            const std::vector<const Stop*>& targets) const {
+    SearchScratch& scratch = GetScratch();
+    RunRounds(static_cast<uint32_t>(from->id), std::nullopt, NO_TIME, scratch);
+    
+    std::vector<std::optional<double>> result;
+    result.reserve(targets.size());
+    for (const Stop* to : targets) {
+        if (to == nullptr) {
+            result.push_back(std::nullopt);
+            continue;
+        }
+        const double time = scratch.arrivals[to->id];
+        result.push_back(time != NO_TIME ? std::optional<double>(time) : std::nullopt);
+    }
+    
+    return result;
+}
+
+std::vector<std::pair<const Stop*, double>> RaptorRouter::BuildTimesWithin(const Stop* from, double max_time) const {
+    SearchScratch& scratch = GetScratch();
+    RunRounds(static_cast<uint32_t>(from->id), std::nullopt, max_time, scratch);
+    
+    std::vector<std::pair<const Stop*, double>> result;
+    for (uint32_t stop_index = 0; stop_index < stops_.size(); ++stop_index) {
+        if (scratch.arrivals[stop_index] != NO_TIME) {
+            result.emplace_back(stops_[stop_index], scratch.arrivals[stop_index]);
+        }
+    }
+    
+    return result;
+}
+
+} //end namespace router
+} //end namespace transport_catalogue
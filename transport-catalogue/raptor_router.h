@@ -0,0 +1,138 @@
+#pragma once
+
+#include "domain.h"
+#include "transport_catalogue.h"
+
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace transport_catalogue {
+namespace router {
+
+// Поиск маршрута по раундам (RAPTOR) прямо по последовательностям остановок автобусов,
+// без графа: раунд k находит лучшее время прибытия на каждую остановку ровно за k поездок.
+// Каждая посадка стоит bus_wait_time. Пересадки - на той же остановке или пешими переходами,
+// переходы можно делать несколько подряд, поездкой они не считаются
+class RaptorRouter {
+public:
+    // поездка или, при bus == nullptr, пеший переход из board_stop в alight_stop
+    struct Leg {
+        const Stop* board_stop = nullptr;
+        const Bus* bus = nullptr;
+        double ride_time = 0;
+        int span_count = 0;
+        const Stop* alight_stop = nullptr;
+    };
+
+    struct Journey {
+        double time = 0;
+        std::vector<Leg> legs;
+    };
+
+    // buses - автобусы, по которым ищутся маршруты; bus_velocity - в метрах в минуту;
+    // max_transfers - наибольшее число пересадок, без него раунды идут,
+    // пока улучшается время хотя бы до одной остановки; walk_pairs - пары id остановок
+    // с пешим переходом в обе стороны, walk_velocity - в метрах в минуту
+    RaptorRouter(const TransportCatalogue& db,
+                 const std::vector<const Bus*>& buses,
+                 double bus_wait_time,
+                 double bus_velocity,
+                 std::optional<int> max_transfers = std::nullopt,
+                 const std::vector<std::pair<size_t, size_t>>& walk_pairs = {},
+                 double walk_velocity = 0);
+
+    std::optional<Journey> BuildRoute(const Stop* from, const Stop* to) const;
+    // Маршруты, оптимальные по Парето по времени и числу поездок, за один поиск: по маршруту
+    // на каждый раунд, улучшивший время до to. Каждый следующий маршрут быстрее предыдущего
+    // и на большее число поездок, последний - самый быстрый
+    std::vector<Journey> BuildParetoRoutes(const Stop* from, const Stop* to) const;
+    // Время до каждой из остановок targets за один общий поиск, nullptr в targets - маршрута нет
+    std::vector<std::optional<double>> BuildTimes(const Stop* from, const std::vector<const Stop*>& targets) const;
+    // Остановки, до которых можно добраться не дольше max_time, со временем в пути
+    std::vector<std::pair<const Stop*, double>> BuildTimesWithin(const Stop* from, double max_time) const;
+
+private:
+    static constexpr uint32_t NO_LABEL = UINT32_MAX;
+    static constexpr uint32_t NO_POSITION = UINT32_MAX;
+    static constexpr uint32_t WALK_ROUTE = UINT32_MAX;
+    static constexpr double NO_TIME = std::numeric_limits<double>::infinity();
+
+    // Как достигнуто время прибытия на остановку: автобусом route с позиции board_position
+    // до позиции alight_position; на остановку посадки приехали по метке parent.
+    // У пешего перехода route - WALK_ROUTE, board_position - остановка, откуда он начат,
+    // alight_position - номер перехода в footpath_stops_
+    struct Label {
+        uint32_t parent = NO_LABEL;
+        uint32_t route = 0;
+        uint32_t board_position = 0;
+        uint32_t alight_position = 0;
+    };
+
+    // Рабочие массивы поиска: плоские массивы по остановкам для текущего и прошлого раунда
+    // и общий массив меток всех раундов. Свои у каждого потока и общие для всех его запросов,
+    // поэтому поиск не выделяет память ни на метку, ни на запрос
+    struct SearchScratch {
+        // лучшее время прибытия за не более чем k поездок и метка, по которой оно получено
+        std::vector<double> arrivals;
+        std::vector<uint32_t> stop_labels;
+        std::vector<Label> labels;
+        
+        std::vector<double> previous_arrivals;
+        std::vector<uint32_t> previous_stop_labels;
+        std::vector<bool> marked;
+        std::vector<uint32_t> marked_stops;
+        std::vector<uint32_t> route_starts;
+        std::vector<uint32_t> queued_routes;
+        // куча Дейкстры по пешим переходам: время прибытия и остановка
+        std::vector<std::pair<double, uint32_t>> footpath_queue;
+    };
+    
+    // Время прибытия на target и его метка после раунда, который это время улучшил
+    struct TargetArrival {
+        double time = 0;
+        uint32_t label = NO_LABEL;
+    };
+    
+    static SearchScratch& GetScratch();
+    
+    // Раунды от остановки source; с target поиск отсекает всё, что не быстрее уже найденного до неё,
+    // а прибытия позже max_time не записываются вовсе. target_arrivals, если задан,
+    // получает время до target после каждого раунда, который его улучшил
+    void RunRounds(uint32_t source, std::optional<uint32_t> target, double max_time, SearchScratch& scratch,
+                   std::vector<TargetArrival>* target_arrivals = nullptr) const;
+    // Пешие переходы от отмеченных остановок: Дейкстра по графу переходов, ведь переходы
+    // можно делать подряд. Улучшенные остановки тоже отмечаются
+    void RelaxFootpaths(std::optional<uint32_t> target, double max_time, SearchScratch& scratch) const;
+    // Поездки маршрута по цепочке меток, которая заканчивается меткой label_index
+    Journey MakeJourney(double time, uint32_t label_index, const std::vector<Label>& labels) const;
+
+    double bus_wait_time_;
+    std::optional<int> max_transfers_;
+
+    // по id остановки
+    std::vector<const Stop*> stops_;
+
+    // маршруты подряд: остановки маршрута r - route_stops_[route_offsets_[r] .. route_offsets_[r + 1]),
+    // route_times_ - время в пути от первой остановки маршрута
+    std::vector<uint32_t> route_offsets_;
+    std::vector<uint32_t> route_stops_;
+    std::vector<double> route_times_;
+    std::vector<const Bus*> route_buses_;
+
+    // маршруты через остановку s и позиции остановки в них (абсолютные индексы в route_stops_)
+    std::vector<uint32_t> stop_route_offsets_;
+    std::vector<uint32_t> stop_routes_;
+    std::vector<uint32_t> stop_positions_;
+
+    // пешие переходы из остановки s - footpath_stops_ и footpath_times_
+    // в [footpath_offsets_[s] .. footpath_offsets_[s + 1]); пусто без переходов
+    std::vector<uint32_t> footpath_offsets_;
+    std::vector<uint32_t> footpath_stops_;
+    std::vector<double> footpath_times_;
+};
+
+} //end namespace router
+} //end namespace transport_catalogue
@@ -9,18 +9,23 @@
  */
 
 #include "json_builder.h"
+#include "thread_pool.h"
 
+#include <algorithm>
 #include <optional>
+#include <thread>
 
 namespace transport_catalogue {
 namespace request_handler {
 
 RequestHandler::RequestHandler(transport_catalogue::TransportCatalogue& db, 
                                const transport_catalogue::renderer::MapRenderer& renderer,
-                               transport_catalogue::router::TransportRouter& router)
+                               transport_catalogue::router::LazyTransportRouter& router,
+                               size_t thread_count)
 : db_(db)
 , renderer_(renderer)
 , router_(router)
+, thread_count_(thread_count > 0 ? thread_count : std::thread::hardware_concurrency())
 {
 }
 
@@ -117,21 +122,47 @@ json::Node RequestHandler::OutputTheSVGMapData(StatRequest& stat_request) {
 json::Node RequestHandler::OutputTheRouteData(StatRequest& stat_request) {
     json::Node node;
     
-    std::optional<router::RouteData> route_data = router_.GetRouteInformation(router_.GetBusWaitingPeriod(db_.GetStop(stat_request.from)).start_bus_wait,
-                                                                      router_.GetBusWaitingPeriod(db_.GetStop(stat_request.to)).start_bus_wait);
+    const Stop* from = db_.GetStop(stat_request.from);
+    const Stop* to = db_.GetStop(stat_request.to);
     
-    if (route_data) {
-        json::Array buffer_array_node;
+    const auto cached_route = router_.Get().GetCachedRoute(from, to, [this](const router::RouteData& route_data) {
+        return OutputTheRouteItems(route_data);
+    });
+    
+    if (cached_route->route && !stat_request.pareto) {
+        node = json::Builder{}.
+               StartDict().
+               Key("request_id").Value(stat_request.id).
+               Key("total_time").Value(cached_route->route->time).
+               Key("items").Value(cached_route->items.GetValue()).
+               EndDict().
+               Build();
         
-        for (const auto& edge : route_data->edges) {
-            buffer_array_node.emplace_back(std::visit(EdgePrinter{}, edge));
+    } else if (cached_route->route) {
+        // маршруты с меньшим числом поездок по возрастанию их числа, последний - самый быстрый
+        json::Array pareto_routes;
+        
+        for (const router::RouteData& route_data : router_.Get().GetParetoRoutes(from, to)) {
+            int ride_count = 0;
+            for (const auto& edge : route_data.edges) {
+                ride_count += std::holds_alternative<router::BusEdge>(edge) ? 1 : 0;
+            }
+            
+            pareto_routes.emplace_back(json::Builder{}.
+                                       StartDict().
+                                       Key("ride_count").Value(ride_count).
+                                       Key("total_time").Value(route_data.time).
+                                       Key("items").Value(OutputTheRouteItems(route_data).GetValue()).
+                                       EndDict().
+                                       Build());
         }
         
         node = json::Builder{}.
                StartDict().
                Key("request_id").Value(stat_request.id).
-               Key("total_time").Value(route_data->time).
-               Key("items").Value(buffer_array_node).
+               Key("total_time").Value(cached_route->route->time).
+               Key("items").Value(cached_route->items.GetValue()).
+               Key("pareto_routes").Value(std::move(pareto_routes)).
                EndDict().
                Build();
         
@@ -148,20 +179,205 @@ json::Node RequestHandler::OutputTheRouteData(StatRequest& stat_request) {
     return node;
 }
 
+json::Node RequestHandler::OutputTheRouteItems(const router::RouteData& route_data) {
+    json::Array buffer_array_node;
+    
+    for (const auto& edge : route_data.edges) {
+        buffer_array_node.emplace_back(std::visit(EdgePrinter{db_}, edge));
+    }
+    
+    return json::Node(std::move(buffer_array_node));
+}
+
+// Таблица времени в пути: строка на каждую остановку from, null - маршрута нет
+// или остановки нет в справочнике
+json::Node RequestHandler::OutputTheMatrixData(StatRequest& stat_request) {
+    std::vector<const Stop*> from_stops;
+    from_stops.reserve(stat_request.from_list.size());
+    for (const std::string& stop_name : stat_request.from_list) {
+        from_stops.push_back(db_.GetStop(stop_name));
+    }
+    
+    std::vector<const Stop*> to_stops;
+    to_stops.reserve(stat_request.to_list.size());
+    for (const std::string& stop_name : stat_request.to_list) {
+        to_stops.push_back(db_.GetStop(stop_name));
+    }
+    
+    json::Array rows;
+    rows.reserve(from_stops.size());
+    
+    for (const Stop* from : from_stops) {
+        json::Array row;
+        row.reserve(to_stops.size());
+        
+        if (from == nullptr) {
+            row.resize(to_stops.size(), json::Node(nullptr));
+        } else {
+            for (const std::optional<double>& time : router_.Get().GetTravelTimes(from, to_stops)) {
+                row.emplace_back(time ? json::Node(*time) : json::Node(nullptr));
+            }
+        }
+        
+        rows.emplace_back(std::move(row));
+    }
+    
+    return json::Builder{}.
+           StartDict().
+           Key("request_id").Value(stat_request.id).
+           Key("times").Value(std::move(rows)).
+           EndDict().
+           Build();
+}
+
+// Остановки в пределах бюджета времени и, по запросу, SVG с их выпуклой оболочкой
+json::Node RequestHandler::OutputTheIsochroneData(StatRequest& stat_request) {
+    const Stop* from = db_.GetStop(stat_request.from);
+    
+    if (from == nullptr) {
+        std::string not_found_str = "not found";
+        return json::Builder{}.
+               StartDict().
+               Key("request_id").Value(stat_request.id).
+               Key("error_message").Value(not_found_str).
+               EndDict().
+               Build();
+    }
+    
+    json::Array stops;
+    std::vector<geo::Coordinates> reachable_coordinates;
+    
+    for (const router::ReachableStop& reachable : router_.Get().GetReachableStops(from, stat_request.max_time)) {
+        stops.emplace_back(json::Builder{}.
+                           StartDict().
+                           Key("stop_name").Value(reachable.stop->name).
+                           Key("time").Value(reachable.time).
+                           EndDict().
+                           Build());
+        reachable_coordinates.push_back(reachable.stop->coord);
+    }
+    
+    if (!stat_request.render_hull) {
+        return json::Builder{}.
+               StartDict().
+               Key("request_id").Value(stat_request.id).
+               Key("stops").Value(std::move(stops)).
+               EndDict().
+               Build();
+    }
+    
+    std::ostringstream svg_stream;
+    renderer_.RenderIsochrone(svg_stream, reachable_coordinates, db_);
+    
+    return json::Builder{}.
+           StartDict().
+           Key("map").Value(svg_stream.str()).
+           Key("request_id").Value(stat_request.id).
+           Key("stops").Value(std::move(stops)).
+           EndDict().
+           Build();
+}
+
+// Самое позднее отправление из каждой остановки from, чтобы прибыть на to к arrive_by,
+// и маршрут в том же виде, что у запроса Route
+json::Node RequestHandler::OutputTheArriveByData(StatRequest& stat_request) {
+    const Stop* to = db_.GetStop(stat_request.to);
+    
+    if (to == nullptr) {
+        std::string not_found_str = "not found";
+        return json::Builder{}.
+               StartDict().
+               Key("request_id").Value(stat_request.id).
+               Key("error_message").Value(not_found_str).
+               EndDict().
+               Build();
+    }
+    
+    // маршруты ищутся только из остановок справочника, для остальных - not found
+    std::vector<const Stop*> from_stops;
+    std::vector<size_t> from_indices;
+    for (size_t i = 0; i < stat_request.from_list.size(); ++i) {
+        if (const Stop* stop = db_.GetStop(stat_request.from_list[i])) {
+            from_stops.push_back(stop);
+            from_indices.push_back(i);
+        }
+    }
+    
+    std::vector<std::optional<router::RouteData>> routes(stat_request.from_list.size());
+    auto found_routes = router_.Get().GetRoutesTo(from_stops, to);
+    for (size_t i = 0; i < found_routes.size(); ++i) {
+        routes[from_indices[i]] = std::move(found_routes[i]);
+    }
+    
+    json::Array result;
+    result.reserve(routes.size());
+    
+    for (size_t i = 0; i < routes.size(); ++i) {
+        if (routes[i]) {
+            result.emplace_back(json::Builder{}.
+                                StartDict().
+                                Key("departure_time").Value(stat_request.arrive_by - routes[i]->time).
+                                Key("from").Value(stat_request.from_list[i]).
+                                Key("items").Value(OutputTheRouteItems(*routes[i]).GetValue()).
+                                Key("total_time").Value(routes[i]->time).
+                                EndDict().
+                                Build());
+        } else {
+            std::string not_found_str = "not found";
+            result.emplace_back(json::Builder{}.
+                                StartDict().
+                                Key("error_message").Value(not_found_str).
+                                Key("from").Value(stat_request.from_list[i]).
+                                EndDict().
+                                Build());
+        }
+    }
+    
+    return json::Builder{}.
+           StartDict().
+           Key("request_id").Value(stat_request.id).
+           Key("routes").Value(std::move(result)).
+           EndDict().
+           Build();
+}
+
+std::optional<json::Node> RequestHandler::ReplyToOneRequest(StatRequest& stat_request) {
+    if (stat_request.type == "Bus") {
+        return OutputTheBusData(stat_request);
+    } else if (stat_request.type == "Stop") {
+        return OutputTheStopData(stat_request);
+    } else if (stat_request.type == "Map") {
+        return OutputTheSVGMapData(stat_request);
+    } else if (stat_request.type == "Route") {
+        return OutputTheRouteData(stat_request);
+    } else if (stat_request.type == "Matrix") {
+        return OutputTheMatrixData(stat_request);
+    } else if (stat_request.type == "Isochrone") {
+        return OutputTheIsochroneData(stat_request);
+    } else if (stat_request.type == "ArriveBy") {
+        return OutputTheArriveByData(stat_request);
+    }
+    
+    return std::nullopt;
+}
+
 json::Document RequestHandler::ReplyToTheRequest(
                std::vector<StatRequest>& stat_requests) {
     
+    std::vector<std::optional<json::Node>> replies(stat_requests.size());
+    
+    // каждый поток берёт следующий ещё не взятый запрос, ответ пишется в ячейку запроса
+    concurrency::ThreadPool thread_pool(std::min(thread_count_, std::max<size_t>(stat_requests.size(), 1)));
+    thread_pool.ParallelFor(stat_requests.size(), [this, &stat_requests, &replies](size_t index) {
+        replies[index] = ReplyToOneRequest(stat_requests[index]);
+    });
+    
     json::Array result;
+    result.reserve(replies.size());
     
-    for (StatRequest& stat_request : stat_requests) {
-        if (stat_request.type == "Bus") {
-            result.push_back(OutputTheBusData(stat_request));
-        } else if (stat_request.type == "Stop") {
-            result.push_back(OutputTheStopData(stat_request));
-        } else if (stat_request.type == "Map") {
-            result.push_back(OutputTheSVGMapData(stat_request));
-        } else if (stat_request.type == "Route") {
-            result.push_back(OutputTheRouteData(stat_request));
+    for (std::optional<json::Node>& reply : replies) {
+        if (reply) {
+            result.push_back(std::move(*reply));
         }
     }
     
@@ -174,7 +390,7 @@ json::Node RequestHandler::EdgePrinter::operator()(const router::StopEdge& stop_
     
     node = json::Builder{}.
            StartDict().
-           Key("stop_name").Value(std::string(stop_edge.name)).
+           Key("stop_name").Value(db.GetStops()[stop_edge.stop_id].name).
            Key("time").Value(stop_edge.time).
            Key("type").Value("Wait").
            EndDict().
@@ -182,12 +398,22 @@ json::Node RequestHandler::EdgePrinter::operator()(const router::StopEdge& stop_
     
     return node;
 }
+json::Node RequestHandler::EdgePrinter::operator()(const router::WalkEdge& walk_edge) {
+    return json::Builder{}.
+           StartDict().
+           Key("from").Value(db.GetStops()[walk_edge.from_stop_id].name).
+           Key("time").Value(walk_edge.time).
+           Key("to").Value(db.GetStops()[walk_edge.to_stop_id].name).
+           Key("type").Value(std::string("Walk")).
+           EndDict().
+           Build();
+}
 json::Node RequestHandler::EdgePrinter::operator()(const router::BusEdge& bus_edge) {
     json::Node node;
     
     node = json::Builder{}.
            StartDict().
-           Key("bus").Value(std::string(bus_edge.name)).
+           Key("bus").Value(db.GetBuses()[bus_edge.bus_id].name).
            Key("span_count").Value(bus_edge.number_of_stops).
            Key("time").Value(bus_edge.time).
            Key("type").Value("Bus").
@@ -23,6 +23,7 @@
 #include "transport_router.h"
 
 #include <iostream>
+#include <optional>
 #include <vector>
 
 namespace transport_catalogue {
@@ -31,26 +32,44 @@ namespace request_handler {
 class RequestHandler {
 public:
     
+    // thread_count - число потоков для ответов на пакет запросов, 0 - по числу ядер
     RequestHandler(transport_catalogue::TransportCatalogue& db, 
                    const transport_catalogue::renderer::MapRenderer& renderer,
-                   transport_catalogue::router::TransportRouter& router);
+                   transport_catalogue::router::LazyTransportRouter& router,
+                   size_t thread_count = 1);
     
     json::Node OutputTheBusData(StatRequest& stat_request);
     json::Node OutputTheStopData(StatRequest& stat_request);
     json::Node OutputTheSVGMapData(StatRequest& stat_request);
     json::Node OutputTheRouteData(StatRequest& stat_request);
+    json::Node OutputTheMatrixData(StatRequest& stat_request);
+    json::Node OutputTheIsochroneData(StatRequest& stat_request);
+    json::Node OutputTheArriveByData(StatRequest& stat_request);
     
+    // Запросы только читают справочник и роутер, поэтому отвечать на них можно
+    // параллельно; ответы в массиве идут в порядке запросов
     json::Document ReplyToTheRequest(std::vector<StatRequest>& stat_requests);
     
 private:
+    // Ответ на один запрос; nullopt - запрос неизвестного типа
+    std::optional<json::Node> ReplyToOneRequest(StatRequest& stat_request);
+    // Массив items ответа на запрос Route
+    json::Node OutputTheRouteItems(const router::RouteData& route_data);
+    
+
     // RequestHandler использует агрегацию объектов "Транспортный Справочник" и "Визуализатор Карты"
     TransportCatalogue& db_;
     const renderer::MapRenderer& renderer_;
-    router::TransportRouter& router_;
+    // строится при первом запросе маршрута
+    router::LazyTransportRouter& router_;
+    size_t thread_count_;
     
     struct EdgePrinter{
+        const TransportCatalogue& db;
+        
         json::Node operator()(const router::StopEdge& stop_edge);
         json::Node operator()(const router::BusEdge& bus_edge);
+        json::Node operator()(const router::WalkEdge& walk_edge);
     };
 };
 
@@ -1,12 +1,16 @@
 #pragma once
 
 #include "graph.h"
+#include "thread_pool.h"
 
 #include <algorithm>
 #include <cassert>
 #include <cstdint>
 #include <iterator>
+#include <functional>
+#include <limits>
 #include <optional>
+#include <queue>
 #include <stdexcept>
 #include <unordered_map>
 #include <utility>
@@ -14,104 +18,353 @@
 
 namespace graph {
 
+// Общий интерфейс движков поиска маршрутов по DirectedWeightedGraph
 template <typename Weight>
-class Router {
-private:
-    using Graph = DirectedWeightedGraph<Weight>;
-
+class RouterBase {
 public:
-    explicit Router(const Graph& graph);
-
     struct RouteInfo {
         Weight weight;
         std::vector<EdgeId> edges;
     };
 
-    std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to) const;
+    virtual ~RouterBase() = default;
+
+    virtual std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to) const = 0;
 
+    // Веса кратчайших маршрутов из from до каждой из targets без восстановления рёбер.
+    // Движки переопределяют метод, чтобы обойтись общим поиском на все цели
+    virtual std::vector<std::optional<Weight>> BuildWeights(VertexId from, const std::vector<VertexId>& targets) const {
+        std::vector<std::optional<Weight>> result;
+        result.reserve(targets.size());
+        for (const VertexId to : targets) {
+            const auto route = BuildRoute(from, to);
+            result.push_back(route ? std::optional<Weight>(route->weight) : std::nullopt);
+        }
+        return result;
+    }
+};
+
+// Предвычисляет кратчайшие пути между всеми парами вершин (Флойд-Уоршелл).
+// Таблица хранится одним массивом и считается блоками BLOCK_SIZE x BLOCK_SIZE:
+// на каждой фазе независимые блоки распределяются по пулу потоков
+template <typename Weight>
+class Router final : public RouterBase<Weight> {
 private:
-    struct RouteInternalData {
-        Weight weight;
-        std::optional<EdgeId> prev_edge;
+    using Graph = DirectedWeightedGraph<Weight>;
+
+public:
+    using RouteInfo = typename RouterBase<Weight>::RouteInfo;
+
+    // Вес в ячейке, между вершинами которой маршрута нет
+    static constexpr Weight NO_ROUTE_WEIGHT = std::numeric_limits<Weight>::max();
+    // Предыдущее ребро маршрута без рёбер (from == to)
+    static constexpr uint32_t NO_EDGE = std::numeric_limits<uint32_t>::max();
+
+    // Компактная таблица: ячейка [from * vertex_count + to] - вес маршрута
+    // и 32-битный id его последнего ребра, отсутствие значений - значения-маркеры
+    struct RoutesInternalData {
+        std::vector<Weight> weights;
+        std::vector<uint32_t> prev_edges;
     };
-    using RoutesInternalData = std::vector<std::vector<std::optional<RouteInternalData>>>;
+
+    explicit Router(const Graph& graph, size_t thread_count = 1);
+    // Восстанавливает роутер по ранее предвычисленным данным без повторного расчёта
+    Router(const Graph& graph, RoutesInternalData routes_internal_data);
+
+    std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to) const override;
+    std::vector<std::optional<Weight>> BuildWeights(VertexId from, const std::vector<VertexId>& targets) const override;
+
+    // Обновляет таблицу после изменения графа, в том числе после добавления вершин, без полного пересчёта.
+    // improved_edges - новые и подешевевшие рёбра: каждое улучшает только те ячейки, где путь
+    // через него короче записанного. worsened_edges - удалённые и подорожавшие рёбра: заново,
+    // Дейкстрой, считаются только строки, маршруты которых через них проходят
+    void UpdateEdges(const std::vector<EdgeId>& improved_edges, const std::vector<EdgeId>& worsened_edges,
+                     size_t thread_count = 1);
+
+    const RoutesInternalData& GetRoutesInternalData() const {
+        return routes_internal_data_;
+    }
+
+private:
+    static constexpr size_t BLOCK_SIZE = 64;
+
+    size_t GetCell(VertexId from, VertexId to) const {
+        return from * vertex_count_ + to;
+    }
 
     void InitializeRoutesInternalData(const Graph& graph) {
-        const size_t vertex_count = graph.GetVertexCount();
-        for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
-            routes_internal_data_[vertex][vertex] = RouteInternalData{ZERO_WEIGHT, std::nullopt};
+        if (graph.GetEdgeCount() >= NO_EDGE) {
+            throw std::length_error("Too many edges for 32-bit edge ids");
+        }
+        auto& weights = routes_internal_data_.weights;
+        auto& prev_edges = routes_internal_data_.prev_edges;
+
+        for (VertexId vertex = 0; vertex < vertex_count_; ++vertex) {
+            weights[GetCell(vertex, vertex)] = ZERO_WEIGHT;
             for (const EdgeId edge_id : graph.GetIncidentEdges(vertex)) {
                 const auto& edge = graph.GetEdge(edge_id);
                 if (edge.weight < ZERO_WEIGHT) {
                     throw std::domain_error("Edges' weights should be non-negative");
                 }
-                auto& route_internal_data = routes_internal_data_[vertex][edge.to];
-                if (!route_internal_data || route_internal_data->weight > edge.weight) {
-                    route_internal_data = RouteInternalData{edge.weight, edge_id};
+                const size_t cell = GetCell(vertex, edge.to);
+                if (weights[cell] > edge.weight) {
+                    weights[cell] = edge.weight;
+                    prev_edges[cell] = static_cast<uint32_t>(edge_id);
                 }
             }
         }
     }
 
-    void RelaxRoute(VertexId vertex_from, VertexId vertex_to, const RouteInternalData& route_from,
-                    const RouteInternalData& route_to) {
-        auto& route_relaxing = routes_internal_data_[vertex_from][vertex_to];
-        const Weight candidate_weight = route_from.weight + route_to.weight;
-        if (!route_relaxing || candidate_weight < route_relaxing->weight) {
-            route_relaxing = {candidate_weight,
-                              route_to.prev_edge ? route_to.prev_edge : route_from.prev_edge};
+    // Релаксирует блок (block_from, block_to) через вершины блока block_through
+    void RelaxBlock(size_t block_from, size_t block_to, size_t block_through) {
+        const VertexId through_end = std::min(vertex_count_, (block_through + 1) * BLOCK_SIZE);
+        const VertexId from_end = std::min(vertex_count_, (block_from + 1) * BLOCK_SIZE);
+        const VertexId to_begin = block_to * BLOCK_SIZE;
+        const VertexId to_end = std::min(vertex_count_, (block_to + 1) * BLOCK_SIZE);
+        Weight* const weights = routes_internal_data_.weights.data();
+        uint32_t* const prev_edges = routes_internal_data_.prev_edges.data();
+
+        for (VertexId vertex_through = block_through * BLOCK_SIZE; vertex_through < through_end; ++vertex_through) {
+            for (VertexId vertex_from = block_from * BLOCK_SIZE; vertex_from < from_end; ++vertex_from) {
+                const size_t cell_from = GetCell(vertex_from, vertex_through);
+                const Weight weight_from = weights[cell_from];
+                if (weight_from == NO_ROUTE_WEIGHT) {
+                    continue;
+                }
+                const uint32_t prev_edge_from = prev_edges[cell_from];
+                for (VertexId vertex_to = to_begin; vertex_to < to_end; ++vertex_to) {
+                    const size_t cell_to = GetCell(vertex_through, vertex_to);
+                    const Weight weight_to = weights[cell_to];
+                    if (weight_to == NO_ROUTE_WEIGHT) {
+                        continue;
+                    }
+                    const size_t cell_relaxing = GetCell(vertex_from, vertex_to);
+                    const Weight candidate_weight = weight_from + weight_to;
+                    if (candidate_weight < weights[cell_relaxing]) {
+                        weights[cell_relaxing] = candidate_weight;
+                        prev_edges[cell_relaxing] = prev_edges[cell_to] != NO_EDGE ? prev_edges[cell_to] : prev_edge_from;
+                    }
+                }
+            }
         }
     }
 
-    void RelaxRoutesInternalDataThroughVertex(size_t vertex_count, VertexId vertex_through) {
-        for (VertexId vertex_from = 0; vertex_from < vertex_count; ++vertex_from) {
-            if (const auto& route_from = routes_internal_data_[vertex_from][vertex_through]) {
-                for (VertexId vertex_to = 0; vertex_to < vertex_count; ++vertex_to) {
-                    if (const auto& route_to = routes_internal_data_[vertex_through][vertex_to]) {
-                        RelaxRoute(vertex_from, vertex_to, *route_from, *route_to);
+    void ComputeRoutesInternalData(concurrency::ThreadPool& thread_pool) {
+        const size_t block_count = (vertex_count_ + BLOCK_SIZE - 1) / BLOCK_SIZE;
+
+        for (size_t block_through = 0; block_through < block_count; ++block_through) {
+            // Фаза 1: диагональный блок зависит только от себя
+            RelaxBlock(block_through, block_through, block_through);
+
+            // Фаза 2: блоки строки и столбца block_through зависят от себя и диагонального
+            thread_pool.ParallelFor(2 * block_count, [this, block_count, block_through](size_t index) {
+                const size_t block = index % block_count;
+                if (block == block_through) {
+                    return;
+                }
+                if (index < block_count) {
+                    RelaxBlock(block_through, block, block_through);
+                } else {
+                    RelaxBlock(block, block_through, block_through);
+                }
+            });
+
+            // Фаза 3: остальные блоки читают только блоки строки и столбца block_through
+            thread_pool.ParallelFor(block_count, [this, block_count, block_through](size_t block_from) {
+                if (block_from == block_through) {
+                    return;
+                }
+                for (size_t block_to = 0; block_to < block_count; ++block_to) {
+                    if (block_to != block_through) {
+                        RelaxBlock(block_from, block_to, block_through);
                     }
                 }
+            });
+        }
+    }
+
+    // Переносит таблицу на новое число вершин; ячейки новых вершин - без маршрутов
+    void ResizeRoutesInternalData(size_t vertex_count) {
+        RoutesInternalData result{std::vector<Weight>(vertex_count * vertex_count, NO_ROUTE_WEIGHT),
+                                  std::vector<uint32_t>(vertex_count * vertex_count, NO_EDGE)};
+        for (VertexId from = 0; from < vertex_count; ++from) {
+            if (from < vertex_count_) {
+                std::copy_n(routes_internal_data_.weights.begin() + GetCell(from, 0), vertex_count_,
+                            result.weights.begin() + from * vertex_count);
+                std::copy_n(routes_internal_data_.prev_edges.begin() + GetCell(from, 0), vertex_count_,
+                            result.prev_edges.begin() + from * vertex_count);
+            } else {
+                result.weights[from * vertex_count + from] = ZERO_WEIGHT;
+            }
+        }
+        routes_internal_data_ = std::move(result);
+        vertex_count_ = vertex_count;
+    }
+
+    // Улучшает ячейки, путь в которые короче через ребро edge_id. Строки независимы:
+    // строка to ребра при этом не меняется, поэтому её можно читать из других потоков
+    void ImproveThroughEdge(EdgeId edge_id, concurrency::ThreadPool& thread_pool) {
+        const auto& edge = graph_.GetEdge(edge_id);
+        if (edge.weight < ZERO_WEIGHT) {
+            throw std::domain_error("Edges' weights should be non-negative");
+        }
+        Weight* const weights = routes_internal_data_.weights.data();
+        uint32_t* const prev_edges = routes_internal_data_.prev_edges.data();
+        if (weights[GetCell(edge.from, edge.to)] <= edge.weight) {
+            return;
+        }
+
+        thread_pool.ParallelFor(vertex_count_, [&](VertexId vertex_from) {
+            const Weight weight_through = weights[GetCell(vertex_from, edge.from)];
+            if (weight_through == NO_ROUTE_WEIGHT || weight_through + edge.weight >= weights[GetCell(vertex_from, edge.to)]) {
+                return;
+            }
+            const Weight weight_from = weight_through + edge.weight;
+            for (VertexId vertex_to = 0; vertex_to < vertex_count_; ++vertex_to) {
+                const size_t cell_to = GetCell(edge.to, vertex_to);
+                if (weights[cell_to] == NO_ROUTE_WEIGHT) {
+                    continue;
+                }
+                const size_t cell_relaxing = GetCell(vertex_from, vertex_to);
+                const Weight candidate_weight = weight_from + weights[cell_to];
+                if (candidate_weight < weights[cell_relaxing]) {
+                    weights[cell_relaxing] = candidate_weight;
+                    prev_edges[cell_relaxing] = prev_edges[cell_to] != NO_EDGE ? prev_edges[cell_to]
+                                                                               : static_cast<uint32_t>(edge_id);
+                }
+            }
+        });
+    }
+
+    // Считает строку from заново поиском Дейкстры по текущему графу
+    void ComputeRow(VertexId from) {
+        using QueueItem = std::pair<Weight, VertexId>;
+        std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>> queue;
+        Weight* const weights = routes_internal_data_.weights.data() + GetCell(from, 0);
+        uint32_t* const prev_edges = routes_internal_data_.prev_edges.data() + GetCell(from, 0);
+        std::fill_n(weights, vertex_count_, NO_ROUTE_WEIGHT);
+        std::fill_n(prev_edges, vertex_count_, NO_EDGE);
+
+        weights[from] = ZERO_WEIGHT;
+        queue.push({ZERO_WEIGHT, from});
+        while (!queue.empty()) {
+            const auto [weight, vertex] = queue.top();
+            queue.pop();
+            if (weight > weights[vertex]) {
+                continue;
+            }
+            for (const EdgeId edge_id : graph_.GetIncidentEdges(vertex)) {
+                const auto& edge = graph_.GetEdge(edge_id);
+                const Weight candidate_weight = weight + edge.weight;
+                if (candidate_weight < weights[edge.to]) {
+                    weights[edge.to] = candidate_weight;
+                    prev_edges[edge.to] = static_cast<uint32_t>(edge_id);
+                    queue.push({candidate_weight, edge.to});
+                }
             }
         }
     }
 
     static constexpr Weight ZERO_WEIGHT{};
     const Graph& graph_;
+    size_t vertex_count_;
     RoutesInternalData routes_internal_data_;
 };
 
 template <typename Weight>
-Router<Weight>::Router(const Graph& graph)
+Router<Weight>::Router(const Graph& graph, size_t thread_count)
     : graph_(graph)
-    , routes_internal_data_(graph.GetVertexCount(),
-                            std::vector<std::optional<RouteInternalData>>(graph.GetVertexCount()))
+    , vertex_count_(graph.GetVertexCount())
+    , routes_internal_data_{std::vector<Weight>(vertex_count_ * vertex_count_, NO_ROUTE_WEIGHT),
+                            std::vector<uint32_t>(vertex_count_ * vertex_count_, NO_EDGE)}
 {
     InitializeRoutesInternalData(graph);
 
-    const size_t vertex_count = graph.GetVertexCount();
-    for (VertexId vertex_through = 0; vertex_through < vertex_count; ++vertex_through) {
-        RelaxRoutesInternalDataThroughVertex(vertex_count, vertex_through);
+    concurrency::ThreadPool thread_pool(thread_count);
+    ComputeRoutesInternalData(thread_pool);
+}
+
+template <typename Weight>
+Router<Weight>::Router(const Graph& graph, RoutesInternalData routes_internal_data)
+    : graph_(graph)
+    , vertex_count_(graph.GetVertexCount())
+    , routes_internal_data_(std::move(routes_internal_data))
+{
+    if (routes_internal_data_.weights.size() != vertex_count_ * vertex_count_
+        || routes_internal_data_.prev_edges.size() != vertex_count_ * vertex_count_) {
+        throw std::invalid_argument("Routes internal data doesn't match the graph");
+    }
+}
+
+template <typename Weight>
+void Router<Weight>::UpdateEdges(const std::vector<EdgeId>& improved_edges, const std::vector<EdgeId>& worsened_edges,
+                                 size_t thread_count) {
+    if (graph_.GetEdgeCount() >= NO_EDGE) {
+        throw std::length_error("Too many edges for 32-bit edge ids");
+    }
+    if (graph_.GetVertexCount() != vertex_count_) {
+        ResizeRoutesInternalData(graph_.GetVertexCount());
+    }
+    concurrency::ThreadPool thread_pool(thread_count);
+
+    // Сначала таблица становится точной для графа, где худшие рёбра ещё прежние:
+    // новые пути только через улучшенные рёбра, по одному ребру за раз
+    for (const EdgeId edge_id : improved_edges) {
+        if (!graph_.IsEdgeRemoved(edge_id)) {
+            ImproveThroughEdge(edge_id, thread_pool);
+        }
+    }
+
+    // Маршрут строки проходит через ребро, только если оно последнее в ячейке своего конца
+    std::vector<VertexId> affected_rows;
+    for (VertexId vertex_from = 0; vertex_from < vertex_count_; ++vertex_from) {
+        for (const EdgeId edge_id : worsened_edges) {
+            if (routes_internal_data_.prev_edges[GetCell(vertex_from, graph_.GetEdge(edge_id).to)] == edge_id) {
+                affected_rows.push_back(vertex_from);
+                break;
+            }
+        }
     }
+    thread_pool.ParallelFor(affected_rows.size(), [this, &affected_rows](size_t index) {
+        ComputeRow(affected_rows[index]);
+    });
 }
 
 template <typename Weight>
 std::optional<typename Router<Weight>::RouteInfo> Router<Weight>::BuildRoute(VertexId from,
                                                                              VertexId to) const {
-    const auto& route_internal_data = routes_internal_data_.at(from).at(to);
-    if (!route_internal_data) {
+    if (from >= vertex_count_ || to >= vertex_count_) {
+        throw std::out_of_range("Vertex id is out of range");
+    }
+    const Weight weight = routes_internal_data_.weights[GetCell(from, to)];
+    if (weight == NO_ROUTE_WEIGHT) {
         return std::nullopt;
     }
-    const Weight weight = route_internal_data->weight;
     std::vector<EdgeId> edges;
-    for (std::optional<EdgeId> edge_id = route_internal_data->prev_edge;
-         edge_id;
-         edge_id = routes_internal_data_[from][graph_.GetEdge(*edge_id).from]->prev_edge)
+    for (uint32_t edge_id = routes_internal_data_.prev_edges[GetCell(from, to)];
+         edge_id != NO_EDGE;
+         edge_id = routes_internal_data_.prev_edges[GetCell(from, graph_.GetEdge(edge_id).from)])
     {
-        edges.push_back(*edge_id);
+        edges.push_back(edge_id);
     }
     std::reverse(edges.begin(), edges.end());
 
     return RouteInfo{weight, std::move(edges)};
 }
 
+template <typename Weight>
+std::vector<std::optional<Weight>> Router<Weight>::BuildWeights(VertexId from,
+                                                                const std::vector<VertexId>& targets) const {
+    std::vector<std::optional<Weight>> result;
+    result.reserve(targets.size());
+    for (const VertexId to : targets) {
+        if (from >= vertex_count_ || to >= vertex_count_) {
+            throw std::out_of_range("Vertex id is out of range");
+        }
+        const Weight weight = routes_internal_data_.weights[GetCell(from, to)];
+        result.push_back(weight != NO_ROUTE_WEIGHT ? std::optional<Weight>(weight) : std::nullopt);
+    }
+    return result;
+}
+
 }  // namespace graph
\ No newline at end of file
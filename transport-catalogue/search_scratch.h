@@ -0,0 +1,169 @@
+#pragma once
+
+#include "graph.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+// Значения по вершинам для поисков, которые повторяются в одном потоке. Reset начинает
+// новый поиск без прохода по всем вершинам: значения прошлых поисков остаются в памяти,
+// но их метки устаревают, и вершины считаются незаписанными
+template <typename Value>
+class VertexMap {
+public:
+    void Reset(size_t vertex_count) {
+        if (values_.size() < vertex_count) {
+            values_.resize(vertex_count);
+            marks_.resize(vertex_count, 0);
+        }
+        if (++mark_ == 0) {
+            std::fill(marks_.begin(), marks_.end(), 0);
+            mark_ = 1;
+        }
+    }
+
+    bool Contains(VertexId vertex) const {
+        return marks_[vertex] == mark_;
+    }
+
+    // nullptr, если в текущем поиске значение не записано
+    const Value* Find(VertexId vertex) const {
+        return Contains(vertex) ? &values_[vertex] : nullptr;
+    }
+
+    // Без проверки: значение должно быть записано в текущем поиске
+    const Value& Get(VertexId vertex) const {
+        return values_[vertex];
+    }
+
+    void Set(VertexId vertex, Value value) {
+        values_[vertex] = std::move(value);
+        marks_[vertex] = mark_;
+    }
+
+private:
+    std::vector<Value> values_;
+    std::vector<uint32_t> marks_;
+    uint32_t mark_ = 0;
+};
+
+// Очередь с минимальным элементом наверху; в отличие от std::priority_queue
+// Clear сохраняет выделенную память для следующего поиска
+template <typename Item>
+class MinHeap {
+public:
+    void Clear() {
+        items_.clear();
+    }
+
+    bool Empty() const {
+        return items_.empty();
+    }
+
+    const Item& Top() const {
+        return items_.front();
+    }
+
+    void Push(Item item) {
+        items_.push_back(std::move(item));
+        std::push_heap(items_.begin(), items_.end(), std::greater<Item>());
+    }
+
+    void Pop() {
+        std::pop_heap(items_.begin(), items_.end(), std::greater<Item>());
+        items_.pop_back();
+    }
+
+private:
+    std::vector<Item> items_;
+};
+
+// Монотонная очередь для целых ключей без знака (radix heap), ключ - первый элемент кортежа Item.
+// Ключ добавляемого элемента не меньше ключа последнего извлечённого, как в Дейкстре
+// без эвристики или с согласованной эвристикой. Элементы лежат в корзинах по старшему биту,
+// в котором их ключ отличается от последнего извлечённого: сравнений между элементами нет,
+// и каждый элемент перекладывается в младшую корзину не больше числа бит ключа раз
+template <typename Item>
+class RadixHeap {
+private:
+    using Key = std::tuple_element_t<0, Item>;
+    static_assert(std::is_integral_v<Key> && std::is_unsigned_v<Key>, "Radix heap keys should be unsigned integers");
+
+public:
+    void Clear() {
+        for (auto& bucket : buckets_) {
+            bucket.clear();
+        }
+        size_ = 0;
+        last_key_ = 0;
+    }
+
+    bool Empty() const {
+        return size_ == 0;
+    }
+
+    const Item& Top() const {
+        Redistribute();
+        return buckets_[0].back();
+    }
+
+    void Push(Item item) {
+        const Key key = std::get<0>(item);
+        if (key < last_key_) {
+            throw std::logic_error("Radix heap keys should not decrease");
+        }
+        buckets_[GetBucket(key)].push_back(std::move(item));
+        ++size_;
+    }
+
+    void Pop() {
+        Redistribute();
+        buckets_[0].pop_back();
+        --size_;
+    }
+
+private:
+    static constexpr size_t BUCKET_COUNT = std::numeric_limits<Key>::digits + 1;
+
+    // 0 - ключ равен последнему извлечённому, иначе номер старшего отличающегося бита с единицы
+    size_t GetBucket(Key key) const {
+        const unsigned long long difference = key ^ last_key_;
+        return difference == 0 ? 0 : std::numeric_limits<unsigned long long>::digits - __builtin_clzll(difference);
+    }
+
+    // Если в корзине 0 пусто, наименьший ключ первой непустой корзины становится последним
+    // извлечённым, и её элементы расходятся по младшим корзинам
+    void Redistribute() const {
+        if (!buckets_[0].empty()) {
+            return;
+        }
+        size_t index = 1;
+        while (buckets_[index].empty()) {
+            ++index;
+        }
+        std::vector<Item>& bucket = buckets_[index];
+        last_key_ = std::get<0>(*std::min_element(bucket.begin(), bucket.end(), [](const Item& lhs, const Item& rhs) {
+            return std::get<0>(lhs) < std::get<0>(rhs);
+        }));
+        for (Item& item : bucket) {
+            buckets_[GetBucket(std::get<0>(item))].push_back(std::move(item));
+        }
+        bucket.clear();
+    }
+
+    mutable std::array<std::vector<Item>, BUCKET_COUNT> buckets_;
+    mutable Key last_key_ = 0;
+    size_t size_ = 0;
+};
+
+}  // namespace graph
@@ -4,6 +4,8 @@
 #include <string_view>
 #include <algorithm>
 #include <iterator>
+#include <limits>
+#include <unordered_map>
 
 
 namespace transport_catalogue {
@@ -11,12 +13,58 @@ namespace serialization {
 
 namespace serialization_detail {
 
-template <typename Iter>
-uint32_t FindIdStops(Iter start, Iter end, std::string_view stop_name) {
-    auto stop_it = std::find_if(start, end, [&stop_name] (const Stop& stop) {
-                                                return stop.name == stop_name;
-                                            });
-    return std::distance(start, stop_it);
+struct EdgeDataSerializer {
+    transport_router_serialize::EdgeData operator()(const router::StopEdge& stop_edge) const {
+        transport_router_serialize::EdgeData result;
+        
+        result.mutable_stop_edge()->set_stop_id(stop_edge.stop_id);
+        result.mutable_stop_edge()->set_time(stop_edge.time);
+        
+        return result;
+    }
+    
+    transport_router_serialize::EdgeData operator()(const router::BusEdge& bus_edge) const {
+        transport_router_serialize::EdgeData result;
+        
+        result.mutable_bus_edge()->set_bus_id(bus_edge.bus_id);
+        result.mutable_bus_edge()->set_time(bus_edge.time);
+        result.mutable_bus_edge()->set_number_of_stops(bus_edge.number_of_stops);
+        
+        return result;
+    }
+    
+    transport_router_serialize::EdgeData operator()(const router::WalkEdge& walk_edge) const {
+        transport_router_serialize::EdgeData result;
+        
+        result.mutable_walk_edge()->set_from_stop_id(walk_edge.from_stop_id);
+        result.mutable_walk_edge()->set_to_stop_id(walk_edge.to_stop_id);
+        result.mutable_walk_edge()->set_time(walk_edge.time);
+        
+        return result;
+    }
+};
+
+graph_serialize::HubLabelSet HubLabelSetSerialization(const graph::HubLabels<double>::LabelSet& labels) {
+    graph_serialize::HubLabelSet result;
+    
+    // массивы переносятся целиком, без разбора по меткам
+    *result.mutable_offsets() = {labels.offsets.begin(), labels.offsets.end()};
+    *result.mutable_hubs() = {labels.hubs.begin(), labels.hubs.end()};
+    *result.mutable_weights() = {labels.weights.begin(), labels.weights.end()};
+    *result.mutable_parent_edges() = {labels.parent_edges.begin(), labels.parent_edges.end()};
+    
+    return result;
+}
+
+graph::HubLabels<double>::LabelSet HubLabelSetDeserialization(const graph_serialize::HubLabelSet& labels_proto) {
+    graph::HubLabels<double>::LabelSet result;
+    
+    result.offsets.assign(labels_proto.offsets().begin(), labels_proto.offsets().end());
+    result.hubs.assign(labels_proto.hubs().begin(), labels_proto.hubs().end());
+    result.weights.assign(labels_proto.weights().begin(), labels_proto.weights().end());
+    result.parent_edges.assign(labels_proto.parent_edges().begin(), labels_proto.parent_edges().end());
+    
+    return result;
 }
 
 } //end namespace serialization_detail
@@ -50,9 +98,7 @@ transport_catalogue_serialize::TransportCatalogue TransportCatalogueSerializatio
         bus_proto.set_name(bus.name);
         
         for (const Stop* stop : bus.stops) {
-            bus_proto.add_stops(serialization_detail::FindIdStops(stops.cbegin(),
-                                                                  stops.cend(),
-                                                                  stop->name));
+            bus_proto.add_stops(stop->id);
         }
         
         bus_proto.set_is_roundtrip(bus.is_roundtrip);
@@ -64,12 +110,8 @@ transport_catalogue_serialize::TransportCatalogue TransportCatalogueSerializatio
         
         transport_catalogue_serialize::Distance distance_proto;
         
-        distance_proto.set_start_stop_id(serialization_detail::FindIdStops(stops.cbegin(), 
-                                                                           stops.cend(), 
-                                                                           pair_stops.first->name));
-        distance_proto.set_end_stop_id(serialization_detail::FindIdStops(stops.cbegin(), 
-                                                                         stops.cend(), 
-                                                                         pair_stops.second->name));
+        distance_proto.set_start_stop_id(pair_stops.first->id);
+        distance_proto.set_end_stop_id(pair_stops.second->id);
         
         distance_proto.set_distance(distance);
         
@@ -150,6 +192,127 @@ transport_router_serialize::RoutingSettings RoutingSettingsSerialization(const r
     
     result.set_bus_wait_time(routing_settings.bus_wait_time);
     result.set_bus_velocity(routing_settings.bus_velocity);
+    result.set_router_type(static_cast<transport_router_serialize::RouterType>(routing_settings.router_type));
+    result.set_graph_model(static_cast<transport_router_serialize::GraphModel>(routing_settings.graph_model));
+    if (routing_settings.max_transfers) {
+        result.set_max_transfers(*routing_settings.max_transfers);
+    }
+    result.set_route_cache_capacity(routing_settings.route_cache_capacity);
+    result.set_fixed_point_weights(routing_settings.fixed_point_weights);
+    result.set_walk_radius(routing_settings.walk_radius);
+    result.set_walk_velocity(routing_settings.walk_velocity);
+    
+    return result;
+}
+
+graph_serialize::Graph GraphSerialization(const graph::DirectedWeightedGraph<double>& graph) {
+    graph_serialize::Graph result;
+    
+    result.set_vertex_count(graph.GetVertexCount());
+    
+    for (graph::EdgeId edge_id = 0; edge_id < graph.GetEdgeCount(); ++edge_id) {
+        const graph::Edge<double>& edge = graph.GetEdge(edge_id);
+        graph_serialize::Edge* edge_proto = result.add_edges();
+        
+        edge_proto->set_from(edge.from);
+        edge_proto->set_to(edge.to);
+        edge_proto->set_weight(edge.weight);
+        edge_proto->set_removed(graph.IsEdgeRemoved(edge_id));
+    }
+    
+    return result;
+}
+
+graph_serialize::RoutesInternalData RoutesInternalDataSerialization(const graph::Router<double>::RoutesInternalData& routes_internal_data) {
+    graph_serialize::RoutesInternalData result;
+    
+    using Router = graph::Router<double>;
+    
+    const size_t cell_count = routes_internal_data.weights.size();
+    result.mutable_weights()->Reserve(cell_count);
+    result.mutable_prev_edges()->Reserve(cell_count);
+    
+    for (size_t cell = 0; cell < cell_count; ++cell) {
+        const double weight = routes_internal_data.weights[cell];
+        const uint32_t prev_edge = routes_internal_data.prev_edges[cell];
+        
+        result.add_weights(weight != Router::NO_ROUTE_WEIGHT ? weight : std::numeric_limits<double>::infinity());
+        result.add_prev_edges(prev_edge != Router::NO_EDGE ? uint64_t{prev_edge} + 1 : 0);
+    }
+    
+    return result;
+}
+
+graph_serialize::ContractionHierarchy ContractionHierarchySerialization(const graph::ContractionHierarchy<double>& contraction_hierarchy) {
+    graph_serialize::ContractionHierarchy result;
+    
+    for (size_t rank : contraction_hierarchy.GetRanks()) {
+        result.add_ranks(rank);
+    }
+    
+    for (const auto& shortcut : contraction_hierarchy.GetShortcuts()) {
+        graph_serialize::Shortcut* shortcut_proto = result.add_shortcuts();
+        
+        shortcut_proto->set_from(shortcut.from);
+        shortcut_proto->set_to(shortcut.to);
+        shortcut_proto->set_weight(shortcut.weight);
+        shortcut_proto->set_first_edge(shortcut.first_edge);
+        shortcut_proto->set_second_edge(shortcut.second_edge);
+    }
+    
+    return result;
+}
+
+graph_serialize::HubLabels HubLabelsSerialization(const graph::HubLabels<double>& hub_labels) {
+    graph_serialize::HubLabels result;
+    
+    *result.mutable_order() = {hub_labels.GetOrder().begin(), hub_labels.GetOrder().end()};
+    *result.mutable_out_labels() = serialization_detail::HubLabelSetSerialization(hub_labels.GetOutLabels());
+    *result.mutable_in_labels() = serialization_detail::HubLabelSetSerialization(hub_labels.GetInLabels());
+    
+    return result;
+}
+
+graph_serialize::Components ComponentsSerialization(const graph::ConnectivityComponents& components) {
+    graph_serialize::Components result;
+    
+    *result.mutable_strong() = {components.GetStrongComponents().begin(), components.GetStrongComponents().end()};
+    *result.mutable_weak() = {components.GetWeakComponents().begin(), components.GetWeakComponents().end()};
+    
+    return result;
+}
+
+transport_router_serialize::TransportRouter TransportRouterSerialization(const router::TransportRouter& transport_router) {
+    transport_router_serialize::TransportRouter result;
+    
+    *result.mutable_graph() = GraphSerialization(transport_router.GetGraph());
+    *result.mutable_components() = ComponentsSerialization(transport_router.GetComponents());
+    
+    for (const router::EdgeData& edge : transport_router.GetEdges()) {
+        *result.add_edges() = std::visit(serialization_detail::EdgeDataSerializer{}, edge);
+    }
+    
+    const auto& bus_waiting_periods = transport_router.GetBusWaitingPeriods();
+    for (uint32_t stop_id = 0; stop_id < bus_waiting_periods.size(); ++stop_id) {
+        const router::BusWaitingPeriod& bus_waiting_period = bus_waiting_periods[stop_id];
+        if (bus_waiting_period.start_bus_wait == router::NO_VERTEX) {
+            continue;
+        }
+        transport_router_serialize::BusWaitingPeriod* bus_waiting_period_proto = result.add_bus_waiting_periods();
+        
+        bus_waiting_period_proto->set_stop_id(stop_id);
+        bus_waiting_period_proto->set_start_bus_wait(bus_waiting_period.start_bus_wait);
+        bus_waiting_period_proto->set_end_bus_wait(bus_waiting_period.end_bus_wait);
+    }
+    
+    if (const auto* all_pairs_router = dynamic_cast<const graph::Router<double>*>(&transport_router.GetRouter())) {
+        *result.mutable_routes_internal_data() = RoutesInternalDataSerialization(all_pairs_router->GetRoutesInternalData());
+    } else if (const auto* contraction_hierarchy = 
+                   dynamic_cast<const graph::ContractionHierarchy<double>*>(&transport_router.GetRouter())) {
+        *result.mutable_contraction_hierarchy() = ContractionHierarchySerialization(*contraction_hierarchy);
+    } else if (const auto* hub_labels = dynamic_cast<const graph::HubLabels<double>*>(&transport_router.GetRouter())) {
+        *result.mutable_hub_labels() = HubLabelsSerialization(*hub_labels);
+    }
     
     return result;
 }
@@ -157,6 +320,7 @@ transport_router_serialize::RoutingSettings RoutingSettingsSerialization(const r
 void Serialization(const TransportCatalogue& transport_catalogue,
                    const renderer::RenderSettings& render_settings,
                    const router::RoutingSettings& routing_settings,
+                   const router::TransportRouter& transport_router,
                    std::ostream& output) {
     
     transport_catalogue_serialize::AggregatedData aggregated_data_proto;
@@ -169,6 +333,10 @@ void Serialization(const TransportCatalogue& transport_catalogue,
     *aggregated_data_proto.mutable_transport_catalogue() = std::move(transport_catalogue_proto);
     *aggregated_data_proto.mutable_render_settings() = std::move(render_settings_proto);
     *aggregated_data_proto.mutable_routing_settings() = std::move(routing_settings_proto);
+    // без графа (RAPTOR) роутер строится по справочнику при загрузке
+    if (transport_router.HasGraph()) {
+        *aggregated_data_proto.mutable_transport_router() = TransportRouterSerialization(transport_router);
+    }
     
     aggregated_data_proto.SerializeToOstream(&output);
 }
@@ -285,13 +453,152 @@ router::RoutingSettings RoutingSettingsDeserialization(const transport_router_se
     
     result.bus_wait_time = routing_settings_proto.bus_wait_time();
     result.bus_velocity = routing_settings_proto.bus_velocity();
+    result.router_type = static_cast<router::RouterType>(routing_settings_proto.router_type());
+    result.graph_model = static_cast<router::GraphModel>(routing_settings_proto.graph_model());
+    if (routing_settings_proto.has_max_transfers()) {
+        result.max_transfers = routing_settings_proto.max_transfers();
+    }
+    if (routing_settings_proto.has_route_cache_capacity()) {
+        result.route_cache_capacity = routing_settings_proto.route_cache_capacity();
+    }
+    result.fixed_point_weights = routing_settings_proto.fixed_point_weights();
+    result.walk_radius = routing_settings_proto.walk_radius();
+    if (result.walk_radius > 0) {
+        result.walk_velocity = routing_settings_proto.walk_velocity();
+    }
+    
+    return result;
+}
+
+std::unique_ptr<graph::DirectedWeightedGraph<double>> GraphDeserialization(const graph_serialize::Graph& graph_proto) {
+    auto result = std::make_unique<graph::DirectedWeightedGraph<double>>(graph_proto.vertex_count());
+    
+    for (const auto& edge_proto : graph_proto.edges()) {
+        const graph::EdgeId edge_id = result->AddEdge(graph::Edge<double>{edge_proto.from(), edge_proto.to(), edge_proto.weight()});
+        if (edge_proto.removed()) {
+            result->RemoveEdge(edge_id);
+        }
+    }
+    
+    return result;
+}
+
+graph::Router<double>::RoutesInternalData RoutesInternalDataDeserialization(const graph_serialize::RoutesInternalData& routes_internal_data_proto,
+                                                                            size_t vertex_count) {
+    using Router = graph::Router<double>;
+    
+    if (static_cast<size_t>(routes_internal_data_proto.weights_size()) != vertex_count * vertex_count
+        || routes_internal_data_proto.prev_edges_size() != routes_internal_data_proto.weights_size()) {
+        throw std::invalid_argument("Routes internal data doesn't match the graph");
+    }
+    
+    Router::RoutesInternalData result;
+    result.weights.reserve(vertex_count * vertex_count);
+    result.prev_edges.reserve(vertex_count * vertex_count);
+    
+    for (size_t cell = 0; cell < vertex_count * vertex_count; ++cell) {
+        const double weight = routes_internal_data_proto.weights(cell);
+        const uint64_t prev_edge = routes_internal_data_proto.prev_edges(cell);
+        
+        result.weights.push_back(weight != std::numeric_limits<double>::infinity() ? weight : Router::NO_ROUTE_WEIGHT);
+        result.prev_edges.push_back(prev_edge != 0 ? static_cast<uint32_t>(prev_edge - 1) : Router::NO_EDGE);
+    }
     
     return result;
 }
 
+std::unique_ptr<graph::ContractionHierarchy<double>> ContractionHierarchyDeserialization(const graph_serialize::ContractionHierarchy& contraction_hierarchy_proto,
+                                                                                      const graph::DirectedWeightedGraph<double>& graph) {
+    std::vector<size_t> ranks(contraction_hierarchy_proto.ranks().begin(), contraction_hierarchy_proto.ranks().end());
+    
+    std::vector<graph::ContractionHierarchy<double>::Shortcut> shortcuts;
+    shortcuts.reserve(contraction_hierarchy_proto.shortcuts_size());
+    
+    for (const auto& shortcut_proto : contraction_hierarchy_proto.shortcuts()) {
+        shortcuts.push_back({shortcut_proto.from(), 
+                             shortcut_proto.to(), 
+                             shortcut_proto.weight(),
+                             shortcut_proto.first_edge(), 
+                             shortcut_proto.second_edge()});
+    }
+    
+    return std::make_unique<graph::ContractionHierarchy<double>>(graph, std::move(ranks), std::move(shortcuts));
+}
+
+std::unique_ptr<graph::HubLabels<double>> HubLabelsDeserialization(const graph_serialize::HubLabels& hub_labels_proto,
+                                                                  const graph::DirectedWeightedGraph<double>& graph) {
+    return std::make_unique<graph::HubLabels<double>>(
+        graph,
+        std::vector<uint32_t>(hub_labels_proto.order().begin(), hub_labels_proto.order().end()),
+        serialization_detail::HubLabelSetDeserialization(hub_labels_proto.out_labels()),
+        serialization_detail::HubLabelSetDeserialization(hub_labels_proto.in_labels()));
+}
+
+std::unique_ptr<graph::ConnectivityComponents> ComponentsDeserialization(const graph_serialize::Components& components_proto) {
+    return std::make_unique<graph::ConnectivityComponents>(
+        std::vector<uint32_t>(components_proto.strong().begin(), components_proto.strong().end()),
+        std::vector<uint32_t>(components_proto.weak().begin(), components_proto.weak().end()));
+}
+
+std::unique_ptr<router::TransportRouter> TransportRouterDeserialization(const transport_router_serialize::TransportRouter& transport_router_proto,
+                                                                        TransportCatalogue& transport_catalogue,
+                                                                        router::RoutingSettings& routing_settings) {
+    std::unique_ptr<graph::DirectedWeightedGraph<double>> graph = GraphDeserialization(transport_router_proto.graph());
+    
+    std::vector<router::EdgeData> edges;
+    edges.reserve(transport_router_proto.edges_size());
+    for (const auto& edge_proto : transport_router_proto.edges()) {
+        if (edge_proto.has_stop_edge()) {
+            edges.emplace_back(router::StopEdge{edge_proto.stop_edge().stop_id(),
+                                                edge_proto.stop_edge().time()});
+        } else if (edge_proto.has_walk_edge()) {
+            edges.emplace_back(router::WalkEdge{edge_proto.walk_edge().from_stop_id(),
+                                                edge_proto.walk_edge().to_stop_id(),
+                                                edge_proto.walk_edge().time()});
+        } else {
+            edges.emplace_back(router::BusEdge{edge_proto.bus_edge().bus_id(),
+                                               edge_proto.bus_edge().time(),
+                                               edge_proto.bus_edge().number_of_stops()});
+        }
+    }
+    
+    std::vector<router::BusWaitingPeriod> bus_waiting_periods(transport_catalogue.GetStops().size());
+    for (const auto& bus_waiting_period_proto : transport_router_proto.bus_waiting_periods()) {
+        bus_waiting_periods.at(bus_waiting_period_proto.stop_id()) =
+            router::BusWaitingPeriod{bus_waiting_period_proto.start_bus_wait(), 
+                                     bus_waiting_period_proto.end_bus_wait()};
+    }
+    
+    std::unique_ptr<graph::RouterBase<double>> router;
+    if (transport_router_proto.has_routes_internal_data()) {
+        router = std::make_unique<graph::Router<double>>(
+            *graph,
+            RoutesInternalDataDeserialization(transport_router_proto.routes_internal_data(), graph->GetVertexCount()));
+    } else if (transport_router_proto.has_contraction_hierarchy()) {
+        router = ContractionHierarchyDeserialization(transport_router_proto.contraction_hierarchy(), *graph);
+    } else if (transport_router_proto.has_hub_labels()) {
+        router = HubLabelsDeserialization(transport_router_proto.hub_labels(), *graph);
+    }
+    
+    // в базах без компонент они считаются при загрузке
+    std::unique_ptr<graph::ConnectivityComponents> components;
+    if (transport_router_proto.has_components()) {
+        components = ComponentsDeserialization(transport_router_proto.components());
+    }
+    
+    return std::make_unique<router::TransportRouter>(transport_catalogue,
+                                                     routing_settings,
+                                                     std::move(graph),
+                                                     std::move(router),
+                                                     std::move(edges),
+                                                     std::move(bus_waiting_periods),
+                                                     std::move(components));
+}
+
 void Deserialization(TransportCatalogue& transport_catalogue, 
                      renderer::RenderSettings& render_settings,
                      router::RoutingSettings& routing_settings,
+                     std::unique_ptr<router::LazyTransportRouter>& transport_router,
                      std::istream& input) {
     
     transport_catalogue_serialize::AggregatedData aggregated_data_proto;
@@ -301,6 +608,21 @@ void Deserialization(TransportCatalogue& transport_catalogue,
     transport_catalogue = TransportCatalogueDeserialization(aggregated_data_proto.transport_catalogue());
     render_settings = RenderSettingsDeserialization(aggregated_data_proto.render_settings());
     routing_settings = RoutingSettingsDeserialization(aggregated_data_proto.routing_settings());
+    
+    if (aggregated_data_proto.has_transport_router()) {
+        auto transport_router_proto = std::make_shared<transport_router_serialize::TransportRouter>();
+        transport_router_proto->Swap(aggregated_data_proto.mutable_transport_router());
+        
+        transport_router = std::make_unique<router::LazyTransportRouter>(
+            [transport_router_proto, &transport_catalogue, &routing_settings] {
+                return TransportRouterDeserialization(*transport_router_proto, transport_catalogue, routing_settings);
+            });
+    } else {
+        transport_router = std::make_unique<router::LazyTransportRouter>(
+            [&transport_catalogue, &routing_settings] {
+                return std::make_unique<router::TransportRouter>(transport_catalogue, routing_settings);
+            });
+    }
 }
 
 
@@ -9,8 +9,11 @@
 #include "transport_router.h"
 #include "transport_router.pb.h"
 
+#include "graph.pb.h"
+
 #include <string>
 #include <iostream>
+#include <memory>
 #include <variant>
 
 namespace transport_catalogue {
@@ -26,10 +29,17 @@ transport_catalogue_serialize::TransportCatalogue TransportCatalogueSerializatio
 colors_serialize::Color ColorSerialization(const svg::Color& color);
 render_serialize::RenderSettings RenderSettingsSerialization(const renderer::RenderSettings& render_settings);
 transport_router_serialize::RoutingSettings RoutingSettingsSerialization(const router::RoutingSettings& routing_settings);
+graph_serialize::Graph GraphSerialization(const graph::DirectedWeightedGraph<double>& graph);
+graph_serialize::RoutesInternalData RoutesInternalDataSerialization(const graph::Router<double>::RoutesInternalData& routes_internal_data);
+graph_serialize::ContractionHierarchy ContractionHierarchySerialization(const graph::ContractionHierarchy<double>& contraction_hierarchy);
+graph_serialize::HubLabels HubLabelsSerialization(const graph::HubLabels<double>& hub_labels);
+graph_serialize::Components ComponentsSerialization(const graph::ConnectivityComponents& components);
+transport_router_serialize::TransportRouter TransportRouterSerialization(const router::TransportRouter& transport_router);
 
 void Serialization(const TransportCatalogue& transport_catalogue,
                    const renderer::RenderSettings& render_settings,
                    const router::RoutingSettings& routing_settings,
+                   const router::TransportRouter& transport_router,
                    std::ostream& output);
 
 //-------------------DESERIALIZATION--------------------
@@ -38,12 +48,24 @@ TransportCatalogue TransportCatalogueDeserialization(const transport_catalogue_s
 svg::Color ColorDeserialization(const colors_serialize::Color& color_proto);
 renderer::RenderSettings RenderSettingsDeserialization(const render_serialize::RenderSettings& render_settings_proto);
 router::RoutingSettings RoutingSettingsDeserialization(const transport_router_serialize::RoutingSettings& routing_settings_proto);
+std::unique_ptr<graph::DirectedWeightedGraph<double>> GraphDeserialization(const graph_serialize::Graph& graph_proto);
+graph::Router<double>::RoutesInternalData RoutesInternalDataDeserialization(const graph_serialize::RoutesInternalData& routes_internal_data_proto,
+                                                                            size_t vertex_count);
+std::unique_ptr<graph::ContractionHierarchy<double>> ContractionHierarchyDeserialization(const graph_serialize::ContractionHierarchy& contraction_hierarchy_proto,
+                                                                                      const graph::DirectedWeightedGraph<double>& graph);
+std::unique_ptr<graph::HubLabels<double>> HubLabelsDeserialization(const graph_serialize::HubLabels& hub_labels_proto,
+                                                                  const graph::DirectedWeightedGraph<double>& graph);
+std::unique_ptr<graph::ConnectivityComponents> ComponentsDeserialization(const graph_serialize::Components& components_proto);
+std::unique_ptr<router::TransportRouter> TransportRouterDeserialization(const transport_router_serialize::TransportRouter& transport_router_proto,
+                                                                        TransportCatalogue& transport_catalogue,
+                                                                        router::RoutingSettings& routing_settings);
 
-//RoutingSettings
-
+// Роутер восстанавливается (или, если в базе его нет, строится по каталогу)
+// только при первом обращении к transport_router
 void Deserialization(TransportCatalogue& transport_catalogue, 
                      renderer::RenderSettings& render_settings,
                      router::RoutingSettings& routing_settings,
+                     std::unique_ptr<router::LazyTransportRouter>& transport_router,
                      std::istream& input);
 
 
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace concurrency {
+
+// Ограниченный кэш, вытесняющий давно не использованные записи (LRU).
+// Ключи распределены по шардам, у каждого свой мьютекс и своя очередь,
+// поэтому потоки с разными ключами почти не мешают друг другу
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class ShardedLruCache {
+public:
+    static constexpr size_t DEFAULT_SHARD_COUNT = 16;
+
+    struct Statistics {
+        size_t hit_count = 0;
+        size_t miss_count = 0;
+        size_t eviction_count = 0;
+    };
+
+    explicit ShardedLruCache(size_t capacity, size_t shard_count = DEFAULT_SHARD_COUNT);
+
+    ShardedLruCache(const ShardedLruCache&) = delete;
+    ShardedLruCache& operator=(const ShardedLruCache&) = delete;
+
+    // Найденное значение становится самым свежим в своём шарде
+    std::optional<Value> Get(const Key& key);
+    void Put(const Key& key, Value value);
+    // Удаляет все записи; счётчики статистики не сбрасываются
+    void Clear();
+
+    Statistics GetStatistics() const {
+        return {hit_count_.load(), miss_count_.load(), eviction_count_.load()};
+    }
+
+private:
+    using Entries = std::list<std::pair<Key, Value>>;
+
+    struct Shard {
+        std::mutex mutex;
+        Entries entries;  // от самой свежей записи к самой старой
+        std::unordered_map<Key, typename Entries::iterator, Hash> positions;
+    };
+
+    Shard& GetShard(const Key& key) {
+        // перемешивание, чтобы шард не зависел от тех же младших битов, что и корзина в positions
+        const uint64_t hash = static_cast<uint64_t>(hasher_(key)) * 0x9E3779B97F4A7C15ull;
+        return shards_[(hash >> 32) % shards_.size()];
+    }
+
+    std::vector<Shard> shards_;
+    size_t shard_capacity_;
+    Hash hasher_;
+
+    std::atomic<size_t> hit_count_ = 0;
+    std::atomic<size_t> miss_count_ = 0;
+    std::atomic<size_t> eviction_count_ = 0;
+};
+
+template <typename Key, typename Value, typename Hash>
+ShardedLruCache<Key, Value, Hash>::ShardedLruCache(size_t capacity, size_t shard_count)
+    : shards_(std::clamp<size_t>(shard_count, 1, std::max<size_t>(capacity, 1)))
+    , shard_capacity_((std::max<size_t>(capacity, 1) + shards_.size() - 1) / shards_.size())
+{
+}
+
+template <typename Key, typename Value, typename Hash>
+std::optional<Value> ShardedLruCache<Key, Value, Hash>::Get(const Key& key) {
+    Shard& shard = GetShard(key);
+    std::lock_guard lock(shard.mutex);
+
+    const auto it = shard.positions.find(key);
+    if (it == shard.positions.end()) {
+        ++miss_count_;
+        return std::nullopt;
+    }
+    ++hit_count_;
+    shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+    return it->second->second;
+}
+
+template <typename Key, typename Value, typename Hash>
+void ShardedLruCache<Key, Value, Hash>::Put(const Key& key, Value value) {
+    Shard& shard = GetShard(key);
+    std::lock_guard lock(shard.mutex);
+
+    if (const auto it = shard.positions.find(key); it != shard.positions.end()) {
+        it->second->second = std::move(value);
+        shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+        return;
+    }
+
+    shard.entries.emplace_front(key, std::move(value));
+    shard.positions[key] = shard.entries.begin();
+
+    if (shard.entries.size() > shard_capacity_) {
+        shard.positions.erase(shard.entries.back().first);
+        shard.entries.pop_back();
+        ++eviction_count_;
+    }
+}
+
+template <typename Key, typename Value, typename Hash>
+void ShardedLruCache<Key, Value, Hash>::Clear() {
+    for (Shard& shard : shards_) {
+        std::lock_guard lock(shard.mutex);
+        shard.positions.clear();
+        shard.entries.clear();
+    }
+}
+
+}  // namespace concurrency
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace concurrency {
+
+// Пул потоков для параллельных циклов: вызывающий поток работает наравне с пулом,
+// поэтому ThreadPool(1) не создаёт дополнительных потоков
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t thread_count = std::thread::hardware_concurrency());
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t GetThreadCount() const {
+        return workers_.size() + 1;
+    }
+
+    // Вызывает func(index) для всех index из [0, count) и дожидается завершения.
+    // Первое выброшенное исключение пробрасывается вызывающему
+    template <typename Func>
+    void ParallelFor(size_t count, Func func);
+
+private:
+    void RunTask();
+    void WorkerLoop();
+
+    std::vector<std::thread> workers_;
+
+    std::mutex mutex_;
+    std::condition_variable task_ready_;
+    std::condition_variable task_done_;
+
+    std::function<void(size_t)> task_;
+    size_t task_size_ = 0;
+    size_t generation_ = 0;
+    size_t active_workers_ = 0;
+    std::atomic<size_t> next_index_ = 0;
+    std::exception_ptr exception_;
+    bool stopped_ = false;
+};
+
+inline ThreadPool::ThreadPool(size_t thread_count) {
+    for (size_t i = 1; i < std::max<size_t>(thread_count, 1); ++i) {
+        workers_.emplace_back([this] {
+            WorkerLoop();
+        });
+    }
+}
+
+inline ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock(mutex_);
+        stopped_ = true;
+    }
+    task_ready_.notify_all();
+    for (std::thread& worker : workers_) {
+        worker.join();
+    }
+}
+
+template <typename Func>
+void ThreadPool::ParallelFor(size_t count, Func func) {
+    if (count == 0) {
+        return;
+    }
+    if (workers_.empty() || count == 1) {
+        for (size_t index = 0; index < count; ++index) {
+            func(index);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard lock(mutex_);
+        task_ = std::ref(func);
+        task_size_ = count;
+        next_index_ = 0;
+        exception_ = nullptr;
+        active_workers_ = workers_.size();
+        ++generation_;
+    }
+    task_ready_.notify_all();
+
+    RunTask();
+
+    std::unique_lock lock(mutex_);
+    task_done_.wait(lock, [this] {
+        return active_workers_ == 0;
+    });
+    task_ = nullptr;
+    if (exception_) {
+        std::rethrow_exception(exception_);
+    }
+}
+
+inline void ThreadPool::RunTask() {
+    for (size_t index = next_index_++; index < task_size_; index = next_index_++) {
+        try {
+            task_(index);
+        } catch (...) {
+            std::lock_guard lock(mutex_);
+            if (!exception_) {
+                exception_ = std::current_exception();
+            }
+            next_index_ = task_size_;
+        }
+    }
+}
+
+inline void ThreadPool::WorkerLoop() {
+    size_t seen_generation = 0;
+    while (true) {
+        {
+            std::unique_lock lock(mutex_);
+            task_ready_.wait(lock, [this, seen_generation] {
+                return stopped_ || generation_ != seen_generation;
+            });
+            if (stopped_) {
+                return;
+            }
+            seen_generation = generation_;
+        }
+
+        RunTask();
+
+        {
+            std::lock_guard lock(mutex_);
+            --active_workers_;
+        }
+        task_done_.notify_one();
+    }
+}
+
+}  // namespace concurrency
@@ -9,11 +9,13 @@
 namespace transport_catalogue {
 
 void TransportCatalogue::AddStop(Stop&& stop) {
+    stop.id = stops_.size();
     stops_.push_back(std::move(stop));
     map_to_stops_.insert({(&stops_.back())->name, &stops_.back()});
 }
 
 void TransportCatalogue::AddBus(Bus&& bus) {
+    bus.id = buses_.size();
     buses_.push_back(std::move(bus));
     map_to_buses_.insert({(&buses_.back())->name, &buses_.back()});
     
@@ -27,6 +29,10 @@ void TransportCatalogue::AddDistanc(const Stop* stop1, const Stop* stop2, double
     
 }
 
+void TransportCatalogue::SetDistance(const Stop* stop1, const Stop* stop2, double distance) {
+    distances_between_stops_[std::make_pair(stop1, stop2)] = distance;
+}
+
 Stop* TransportCatalogue::GetStop(std::string_view stop_name) {
     if (map_to_stops_.count(stop_name) != 0) {
         return map_to_stops_.at(stop_name);
@@ -40,6 +40,8 @@ public:
     void AddStop(Stop&& stop);
     void AddBus(Bus&& bus);
     void AddDistanc(const Stop* stop1, const Stop* stop2, double distance);
+    // В отличие от AddDistanc заменяет уже заданное расстояние
+    void SetDistance(const Stop* stop1, const Stop* stop2, double distance);
     
     Stop* GetStop(std::string_view stop_name);
     Bus* GetBus(std::string_view bus_name);
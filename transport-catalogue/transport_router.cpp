@@ -1,5 +1,9 @@
 #include "transport_router.h"
 
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+
 namespace transport_catalogue {
 namespace router {
 
@@ -7,60 +11,350 @@ TransportRouter::TransportRouter(TransportCatalogue& db, RoutingSettings& routin
 : db_(db)
 , routing_settings_(routing_settings)
 {
-    SetGraph();
-    router_ = std::make_unique<graph::Router<double>>(*graph_);
+    buses_in_service_.assign(db_.GetBuses().size(), true);
+    if (routing_settings_.router_type != RouterType::RAPTOR) {
+        SetGraph();
+        SetComponents();
+        SetStopByVertex();
+    }
+    SetRouter();
+    SetRouteCache();
+}
+
+TransportRouter::TransportRouter(TransportCatalogue& db,
+                                 RoutingSettings& routing_settings,
+                                 std::unique_ptr<graph::DirectedWeightedGraph<double>> graph,
+                                 std::unique_ptr<graph::RouterBase<double>> router,
+                                 std::vector<EdgeData> edges,
+                                 std::vector<BusWaitingPeriod> bus_waiting_periods,
+                                 std::unique_ptr<graph::ConnectivityComponents> components)
+: db_(db)
+, routing_settings_(routing_settings)
+, graph_(std::move(graph))
+, router_(std::move(router))
+, components_(std::move(components))
+, edges_(std::move(edges))
+, bus_waiting_periods_(std::move(bus_waiting_periods))
+{
+    buses_in_service_.assign(db_.GetBuses().size(), true);
+    if (!components_) {
+        SetComponents();
+    }
+    SetStopByVertex();
+    if (!router_) {
+        SetRouter();
+    }
+    SetRouteCache();
 }
 
-void TransportRouter::SetStops() {
-    size_t position = 0;
+// В граф входят остановки автобусов и остановки с пешими переходами. Вершины идут
+// вдоль кривой Гильберта по координатам: у соседних остановок близкие номера,
+// и поиск по графу реже промахивается мимо кэша
+size_t TransportRouter::SetStops(const std::vector<std::pair<size_t, size_t>>& walk_pairs) {
+    const auto& stops = db_.GetStops();
+    std::vector<bool> is_in_graph(stops.size(), false);
+    for (const Bus* bus : GetBusesInService()) {
+        for (const Stop* stop : bus->stops) {
+            is_in_graph[stop->id] = true;
+        }
+    }
+    for (const auto& [first, second] : walk_pairs) {
+        is_in_graph[first] = true;
+        is_in_graph[second] = true;
+    }
     
-    for (const auto [_, stop] : db_.GetMapToStop()) {
-        map_stop_to_bus_period_[stop] = BusWaitingPeriod{position, position+1};
-        
-        position += 2;
+    std::vector<size_t> stop_ids;
+    std::vector<geo::Coordinates> coordinates;
+    for (const Stop& stop : stops) {
+        if (is_in_graph[stop.id]) {
+            stop_ids.push_back(stop.id);
+            coordinates.push_back(stop.coord);
+        }
+    }
+    
+    const size_t vertices_per_stop = routing_settings_.graph_model == GraphModel::COLLAPSED ? 1 : 2;
+    bus_waiting_periods_.assign(stops.size(), BusWaitingPeriod{});
+    graph::VertexId vertex = 0;
+    for (const size_t index : geo::OrderAlongHilbertCurve(coordinates)) {
+        bus_waiting_periods_[stop_ids[index]] = BusWaitingPeriod{vertex, vertex + vertices_per_stop - 1};
+        vertex += vertices_per_stop;
     }
+    
+    return vertex;
+}
+
+void TransportRouter::AddEdge(const graph::Edge<double>& edge, EdgeData edge_data) {
+    graph_->AddEdge(edge);
+    edges_.push_back(std::move(edge_data));
 }
 
 void TransportRouter::AddEdgeToStop() {
-    for (const auto [stop, summit_number] : map_stop_to_bus_period_) {
-        size_t edge_id = graph_->AddEdge(graph::Edge<double>{summit_number.start_bus_wait,
-                                                                    summit_number.end_bus_wait,
-                                                                    routing_settings_.bus_wait_time});
-        
-        map_id_to_edge_[edge_id] = StopEdge{stop->name, routing_settings_.bus_wait_time};
+    for (const Stop& stop : db_.GetStops()) {
+        const BusWaitingPeriod& period = bus_waiting_periods_[stop.id];
+        if (period.start_bus_wait == NO_VERTEX) {
+            continue;
+        }
+        AddEdge(graph::Edge<double>{period.start_bus_wait, period.end_bus_wait, routing_settings_.bus_wait_time},
+                StopEdge{static_cast<uint32_t>(stop.id), routing_settings_.bus_wait_time});
     }
 }
 void TransportRouter::AddEdgeToBus() {
     for (const auto [_, bus] : db_.GetMapToBus()) {
-        FillBusToEdge(bus->stops.begin(),
-                      bus->stops.end(),
-                      bus);
-        if (!bus->is_roundtrip) {
-            FillBusToEdge(bus->stops.rbegin(),
-                          bus->stops.rend(),
-                          bus);
+        for (const auto& [edge, edge_data] : MakeBusEdges(bus, 0)) {
+            AddEdge(edge, edge_data);
+        }
+    }
+}
+
+void TransportRouter::AddWalkEdge(const Stop& from, const Stop& to) {
+    const double time = geo::ComputeDistance(from.coord, to.coord)
+                        / (routing_settings_.walk_velocity * METERS_IN_A_KILOMETER / MINUTES_PER_HOUR);
+    
+    AddEdge(graph::Edge<double>{bus_waiting_periods_[from.id].start_bus_wait, bus_waiting_periods_[to.id].start_bus_wait, time},
+            WalkEdge{static_cast<uint32_t>(from.id), static_cast<uint32_t>(to.id), time});
+}
+
+std::vector<std::pair<size_t, size_t>> TransportRouter::FindWalkPairs() const {
+    if (!(routing_settings_.walk_radius > 0)) {
+        return {};
+    }
+    
+    const auto& stops = db_.GetStops();
+    std::vector<geo::Coordinates> coordinates;
+    coordinates.reserve(stops.size());
+    for (const Stop& stop : stops) {
+        coordinates.push_back(stop.coord);
+    }
+    
+    return geo::FindClosePairs(coordinates, routing_settings_.walk_radius);
+}
+
+// Переход ведёт от прибытия на остановку к прибытию на соседнюю: дальше ожидание автобуса или конец маршрута
+void TransportRouter::AddWalkEdges(const std::vector<std::pair<size_t, size_t>>& walk_pairs) {
+    const auto& stops = db_.GetStops();
+    for (const auto& [first, second] : walk_pairs) {
+        AddWalkEdge(stops[first], stops[second]);
+        AddWalkEdge(stops[second], stops[first]);
+    }
+}
+
+// Вершины автобуса идут подряд после вершин остановок
+void TransportRouter::AddRoutePatterns(graph::VertexId first_vertex) {
+    graph::VertexId vertex = first_vertex;
+    
+    for (const auto [_, bus] : db_.GetMapToBus()) {
+        for (const auto& [edge, edge_data] : MakeBusEdges(bus, vertex)) {
+            AddEdge(edge, edge_data);
         }
+        vertex += bus->stops.size();
     }
 }
 
+// В модели маршрутов посадка и высадка - рёбра нулевого веса,
+// поездка складывается из перегонов между соседними остановками
+TransportRouter::BusEdges TransportRouter::MakeBusEdges(const Bus* bus, graph::VertexId first_vertex) const {
+    BusEdges result;
+    
+    switch (routing_settings_.graph_model) {
+        case GraphModel::COMPLETE:
+        case GraphModel::COLLAPSED:
+            FillBusToEdge(bus->stops.begin(),
+                          bus->stops.end(),
+                          bus,
+                          result);
+            if (!bus->is_roundtrip) {
+                FillBusToEdge(bus->stops.rbegin(),
+                              bus->stops.rend(),
+                              bus,
+                              result);
+            }
+            // в свёрнутой модели ожидание перед посадкой - часть ребра, в описании ребра только поездка
+            if (routing_settings_.graph_model == GraphModel::COLLAPSED) {
+                for (auto& [edge, _] : result) {
+                    edge.weight += routing_settings_.bus_wait_time;
+                }
+            }
+            break;
+        case GraphModel::ROUTE_PATTERN: {
+            graph::VertexId vertex = first_vertex;
+            const uint32_t bus_id = static_cast<uint32_t>(bus->id);
+            
+            for (auto it = bus->stops.begin(); it != bus->stops.end(); ++it, ++vertex) {
+                const BusWaitingPeriod& period = bus_waiting_periods_[(*it)->id];
+                
+                if (it != bus->stops.begin()) {
+                    const double distance = db_.GetDistanceBetweenStops(*prev(it), *it);
+                    const double time = distance / (routing_settings_.bus_velocity * METERS_IN_A_KILOMETER / MINUTES_PER_HOUR);
+                    
+                    result.emplace_back(graph::Edge<double>{vertex - 1, vertex, time}, BusEdge{bus_id, time, 1});
+                    result.emplace_back(graph::Edge<double>{vertex, period.start_bus_wait, 0}, BusEdge{bus_id, 0, 0});
+                }
+                if (next(it) != bus->stops.end()) {
+                    result.emplace_back(graph::Edge<double>{period.end_bus_wait, vertex, 0}, BusEdge{bus_id, 0, 0});
+                }
+            }
+            break;
+        }
+    }
+    
+    return result;
+}
+
 void TransportRouter::SetGraph() {
-    const size_t stops_ptr_size = db_.GetMapToStop().size();
+    const auto walk_pairs = FindWalkPairs();
+    const size_t stop_vertex_count = SetStops(walk_pairs);
+    size_t vertex_count = stop_vertex_count;
+    
+    if (routing_settings_.graph_model == GraphModel::ROUTE_PATTERN) {
+        for (const auto [_, bus] : db_.GetMapToBus()) {
+            vertex_count += bus->stops.size();
+        }
+    }
     
-    graph_ = std::make_unique<graph::DirectedWeightedGraph<double>>(2 * stops_ptr_size);
+    graph_ = std::make_unique<graph::DirectedWeightedGraph<double>>(vertex_count);
+    
+    if (routing_settings_.graph_model != GraphModel::COLLAPSED) {
+        AddEdgeToStop();
+    }
+    switch (routing_settings_.graph_model) {
+        case GraphModel::COMPLETE:
+        case GraphModel::COLLAPSED:
+            AddEdgeToBus();
+            break;
+        case GraphModel::ROUTE_PATTERN:
+            AddRoutePatterns(stop_vertex_count);
+            break;
+    }
+    AddWalkEdges(walk_pairs);
     
-    SetStops();
+}
+
+void TransportRouter::FreezeGraph() {
+    csr_graph_ = std::make_unique<graph::CsrGraph<double>>(*graph_);
+}
+
+void TransportRouter::SetComponents() {
+    components_ = std::make_unique<graph::ConnectivityComponents>(*graph_);
+}
+
+void TransportRouter::SetGeoLowerBound() {
+    vertex_coordinates_.resize(graph_->GetVertexCount());
+    std::vector<bool> is_stop_vertex(graph_->GetVertexCount(), false);
+    for (size_t stop_id = 0; stop_id < bus_waiting_periods_.size(); ++stop_id) {
+        const BusWaitingPeriod& period = bus_waiting_periods_[stop_id];
+        if (period.start_bus_wait == NO_VERTEX) {
+            continue;
+        }
+        vertex_coordinates_[period.start_bus_wait] = db_.GetStops()[stop_id].coord;
+        vertex_coordinates_[period.end_bus_wait] = db_.GetStops()[stop_id].coord;
+        is_stop_vertex[period.start_bus_wait] = true;
+        is_stop_vertex[period.end_bus_wait] = true;
+    }
+    // вершины автобусов в модели маршрутов получают координаты остановки посадки или высадки
+    for (graph::EdgeId edge_id = 0; edge_id < graph_->GetEdgeCount(); ++edge_id) {
+        const auto& edge = graph_->GetEdge(edge_id);
+        if (!is_stop_vertex[edge.from] && is_stop_vertex[edge.to]) {
+            vertex_coordinates_[edge.from] = vertex_coordinates_[edge.to];
+        } else if (is_stop_vertex[edge.from] && !is_stop_vertex[edge.to]) {
+            vertex_coordinates_[edge.to] = vertex_coordinates_[edge.from];
+        }
+    }
     
-    AddEdgeToStop();
-    AddEdgeToBus();
+    // дорога может оказаться короче расстояния по прямой, поэтому оценка
+    // уменьшается на наименьшее отношение дороги к прямой среди перегонов
+    double road_to_geo_ratio = 1;
+    for (const Bus* bus : GetBusesInService()) {
+        for (auto it = std::next(bus->stops.begin()); it < bus->stops.end(); ++it) {
+            const double geo_distance = geo::ComputeDistance((*prev(it))->coord, (*it)->coord);
+            if (!(geo_distance > 0)) {
+                continue;
+            }
+            road_to_geo_ratio = std::min(road_to_geo_ratio,
+                                         db_.GetDistanceBetweenStops(*prev(it), *it) / geo_distance);
+            if (!bus->is_roundtrip) {
+                road_to_geo_ratio = std::min(road_to_geo_ratio,
+                                             db_.GetDistanceBetweenStops(*it, *prev(it)) / geo_distance);
+            }
+        }
+    }
     
+    minutes_per_geo_meter_ = road_to_geo_ratio
+        / (routing_settings_.bus_velocity * METERS_IN_A_KILOMETER / MINUTES_PER_HOUR);
+    // пешком по прямой, но пешеход может оказаться быстрее автобуса
+    if (routing_settings_.walk_radius > 0) {
+        minutes_per_geo_meter_ = std::min(minutes_per_geo_meter_,
+                                          1 / (routing_settings_.walk_velocity * METERS_IN_A_KILOMETER / MINUTES_PER_HOUR));
+    }
+}
+
+void TransportRouter::SetRouter() {
+    switch (routing_settings_.router_type) {
+        case RouterType::ALL_PAIRS:
+            router_ = std::make_unique<graph::Router<double>>(*graph_, std::thread::hardware_concurrency());
+            break;
+        case RouterType::DIJKSTRA:
+            if (routing_settings_.fixed_point_weights) {
+                router_ = std::make_unique<graph::FixedPointRouter<uint32_t>>(*graph_, MILLISECONDS_PER_MINUTE);
+                break;
+            }
+            if (!csr_graph_) {
+                FreezeGraph();
+            }
+            router_ = std::make_unique<graph::DijkstraRouter<double, graph::CsrGraph<double>>>(*csr_graph_);
+            break;
+        case RouterType::CONTRACTION_HIERARCHY:
+            router_ = std::make_unique<graph::ContractionHierarchy<double>>(*graph_);
+            break;
+        case RouterType::HUB_LABELS:
+            router_ = std::make_unique<graph::HubLabels<double>>(*graph_);
+            break;
+        case RouterType::ASTAR:
+            if (!csr_graph_) {
+                FreezeGraph();
+            }
+            SetGeoLowerBound();
+            router_ = std::make_unique<graph::DijkstraRouter<double, graph::CsrGraph<double>>>(
+                *csr_graph_,
+                [this](graph::VertexId vertex, graph::VertexId target) {
+                    return GetGeoLowerBound(vertex, target);
+                });
+            break;
+        case RouterType::ALT:
+            if (!csr_graph_) {
+                FreezeGraph();
+            }
+            SetGeoLowerBound();
+            landmarks_ = std::make_unique<graph::Landmarks<double>>(*graph_);
+            router_ = std::make_unique<graph::DijkstraRouter<double, graph::CsrGraph<double>>>(
+                *csr_graph_,
+                [this](graph::VertexId vertex, graph::VertexId target) {
+                    return std::max(GetGeoLowerBound(vertex, target), landmarks_->GetLowerBound(vertex, target));
+                });
+            break;
+        case RouterType::RAPTOR:
+            raptor_router_ = std::make_unique<RaptorRouter>(db_,
+                                                            GetBusesInService(),
+                                                            routing_settings_.bus_wait_time,
+                                                            routing_settings_.bus_velocity * METERS_IN_A_KILOMETER / MINUTES_PER_HOUR,
+                                                            routing_settings_.max_transfers,
+                                                            FindWalkPairs(),
+                                                            routing_settings_.walk_velocity * METERS_IN_A_KILOMETER / MINUTES_PER_HOUR);
+            break;
+    }
 }
 
-const graph::Edge<double> TransportRouter::СreateEdgeToBus(Stop* start_stop, Stop* end_stop, const double distance) {
+void TransportRouter::SetRouteCache() {
+    if (routing_settings_.route_cache_capacity > 0) {
+        route_cache_ = std::make_unique<RouteCache>(routing_settings_.route_cache_capacity);
+    }
+}
+
+const graph::Edge<double> TransportRouter::СreateEdgeToBus(Stop* start_stop, Stop* end_stop, const double distance) const {
     
     graph::Edge<double> result;
     
-    result.from = map_stop_to_bus_period_.at(start_stop).end_bus_wait;
-    result.to = map_stop_to_bus_period_.at(end_stop).start_bus_wait;
+    result.from = bus_waiting_periods_[start_stop->id].end_bus_wait;
+    result.to = bus_waiting_periods_[end_stop->id].start_bus_wait;
     result.weight = distance  / (routing_settings_.bus_velocity * METERS_IN_A_KILOMETER / MINUTES_PER_HOUR);
     
     return result;
@@ -68,25 +362,560 @@ const graph::Edge<double> TransportRouter::СreateEdgeToBus(Stop* start_stop, St
 
 
 std::optional<RouteData> TransportRouter::GetRouteInformation(size_t from, size_t to) {
+    if (!components_->MayReach(from, to)) {
+        return std::nullopt;
+    }
+    
     const auto& route_info = router_->BuildRoute(from, to);
     
     if (route_info) {
-        RouteData result;
-        
-        result.time = route_info->weight;
+        return MakeRouteData(route_info->weight, route_info->edges);
+    }
+    
+    return std::nullopt;
+}
+
+RouteData TransportRouter::MakeRouteData(double time, const std::vector<graph::EdgeId>& edge_ids) const {
+    RouteData result;
+    
+    result.time = time;
+    
+    for (const graph::EdgeId id : edge_ids) {
+        const EdgeData& edge = edges_[id];
         
-        for (const size_t id : route_info->edges) {
-            result.edges.emplace_back(map_id_to_edge_.at(id));
+        // в свёрнутой модели ожидание входит в ребро автобуса и восстанавливается по остановке посадки
+        if (routing_settings_.graph_model == GraphModel::COLLAPSED && std::holds_alternative<BusEdge>(edge)) {
+            const Stop* stop = stop_by_vertex_[graph_->GetEdge(id).from];
+            result.edges.emplace_back(StopEdge{static_cast<uint32_t>(stop->id), routing_settings_.bus_wait_time});
+            result.edges.emplace_back(edge);
+            continue;
         }
         
-        return result;
+        // в модели маршрутов одна поездка - несколько рёбер автобуса подряд
+        if (!result.edges.empty()
+            && std::holds_alternative<BusEdge>(edge)
+            && std::holds_alternative<BusEdge>(result.edges.back())) {
+            BusEdge& bus_edge = std::get<BusEdge>(result.edges.back());
+            bus_edge.time += std::get<BusEdge>(edge).time;
+            bus_edge.number_of_stops += std::get<BusEdge>(edge).number_of_stops;
+        } else {
+            result.edges.emplace_back(edge);
+        }
+    }
+    
+    return result;
+}
+
+std::optional<RouteData> TransportRouter::GetRouteInformation(const Stop* from, const Stop* to) {
+    if (!raptor_router_) {
+        // остановки нет в графе: маршрут есть только до неё самой
+        if (!IsStopInGraph(from) || !IsStopInGraph(to)) {
+            return from == to ? std::optional<RouteData>(RouteData{0, {}}) : std::nullopt;
+        }
+        return GetRouteInformation(GetBusWaitingPeriod(from).start_bus_wait,
+                                   GetBusWaitingPeriod(to).start_bus_wait);
+    }
+    
+    const auto journey = raptor_router_->BuildRoute(from, to);
+    
+    if (journey) {
+        return MakeRouteData(*journey);
     }
     
     return std::nullopt;
 }
 
-BusWaitingPeriod TransportRouter::GetBusWaitingPeriod(Stop* stop) {
-    return map_stop_to_bus_period_.at(stop);
+RouteData TransportRouter::MakeRouteData(const RaptorRouter::Journey& journey) const {
+    RouteData result;
+    
+    result.time = journey.time;
+    
+    for (const RaptorRouter::Leg& leg : journey.legs) {
+        if (!leg.bus) {
+            result.edges.emplace_back(WalkEdge{static_cast<uint32_t>(leg.board_stop->id),
+                                               static_cast<uint32_t>(leg.alight_stop->id),
+                                               leg.ride_time});
+            continue;
+        }
+        result.edges.emplace_back(StopEdge{static_cast<uint32_t>(leg.board_stop->id), routing_settings_.bus_wait_time});
+        result.edges.emplace_back(BusEdge{static_cast<uint32_t>(leg.bus->id), leg.ride_time, leg.span_count});
+    }
+    
+    return result;
+}
+
+std::vector<RouteData> TransportRouter::GetParetoRoutes(const Stop* from, const Stop* to) {
+    const RaptorRouter* raptor_router = raptor_router_.get();
+    if (!raptor_router) {
+        std::call_once(pareto_built_, [this] {
+            SetParetoRouter();
+        });
+        raptor_router = pareto_router_.get();
+    }
+    
+    std::vector<RouteData> result;
+    for (const RaptorRouter::Journey& journey : raptor_router->BuildParetoRoutes(from, to)) {
+        result.push_back(MakeRouteData(journey));
+    }
+    
+    return result;
+}
+
+std::shared_ptr<const CachedRoute> TransportRouter::GetCachedRoute(const Stop* from, const Stop* to,
+                                                                  const RouteItemsBuilder& build_items) {
+    const std::pair<const Stop*, const Stop*> key{from, to};
+    
+    if (route_cache_) {
+        if (auto cached_route = route_cache_->Get(key)) {
+            return *cached_route;
+        }
+    }
+    
+    auto result = std::make_shared<CachedRoute>();
+    result->route = GetRouteInformation(from, to);
+    if (result->route) {
+        result->items = build_items(*result->route);
+    }
+    
+    if (route_cache_) {
+        route_cache_->Put(key, result);
+    }
+    
+    return result;
+}
+
+RouteCache::Statistics TransportRouter::GetRouteCacheStatistics() const {
+    return route_cache_ ? route_cache_->GetStatistics() : RouteCache::Statistics{};
+}
+
+std::vector<std::optional<double>> TransportRouter::GetTravelTimes(const Stop* from, const std::vector<const Stop*>& to) {
+    if (from == nullptr) {
+        return std::vector<std::optional<double>>(to.size());
+    }
+    if (raptor_router_) {
+        return raptor_router_->BuildTimes(from, to);
+    }
+    
+    // поиск идёт только до остановок, путь до которых возможен;
+    // остановки, которой нет в графе, достижима только она сама
+    std::vector<std::optional<double>> result(to.size());
+    const graph::VertexId source = GetBusWaitingPeriod(from).start_bus_wait;
+    std::vector<graph::VertexId> targets;
+    std::vector<size_t> target_indices;
+    for (size_t i = 0; i < to.size(); ++i) {
+        if (to[i] == nullptr) {
+            continue;
+        }
+        const graph::VertexId target = GetBusWaitingPeriod(to[i]).start_bus_wait;
+        if (source == NO_VERTEX || target == NO_VERTEX) {
+            if (to[i] == from) {
+                result[i] = 0;
+            }
+        } else if (components_->MayReach(source, target)) {
+            targets.push_back(target);
+            target_indices.push_back(i);
+        }
+    }
+    
+    if (targets.empty()) {
+        return result;
+    }
+    
+    const auto weights = router_->BuildWeights(source, targets);
+    for (size_t i = 0; i < weights.size(); ++i) {
+        result[target_indices[i]] = weights[i];
+    }
+    
+    return result;
+}
+
+std::vector<std::optional<RouteData>> TransportRouter::GetRoutesTo(const std::vector<const Stop*>& from, const Stop* to) {
+    std::vector<std::optional<RouteData>> result;
+    result.reserve(from.size());
+    
+    // RAPTOR ищет только вперёд, маршрут из каждой остановки строится отдельно
+    if (raptor_router_) {
+        for (const Stop* stop : from) {
+            result.push_back(stop && to ? GetRouteInformation(stop, to) : std::nullopt);
+        }
+        return result;
+    }
+    
+    result.resize(from.size());
+    if (to == nullptr) {
+        return result;
+    }
+    
+    std::call_once(reverse_built_, [this] {
+        SetReverseRouter();
+    });
+    
+    // поиск идёт только до остановок, из которых путь возможен;
+    // из остановки, которой нет в графе, маршрут есть только до неё самой
+    const graph::VertexId source = GetBusWaitingPeriod(to).start_bus_wait;
+    std::vector<graph::VertexId> targets;
+    std::vector<size_t> target_indices;
+    for (size_t i = 0; i < from.size(); ++i) {
+        if (from[i] == nullptr) {
+            continue;
+        }
+        const graph::VertexId target = GetBusWaitingPeriod(from[i]).start_bus_wait;
+        if (source == NO_VERTEX || target == NO_VERTEX) {
+            if (from[i] == to) {
+                result[i] = RouteData{0, {}};
+            }
+        } else if (components_->MayReach(target, source)) {
+            targets.push_back(target);
+            target_indices.push_back(i);
+        }
+    }
+    
+    if (targets.empty()) {
+        return result;
+    }
+    
+    auto route_infos = reverse_router_->BuildRoutes(source, targets);
+    for (size_t i = 0; i < route_infos.size(); ++i) {
+        auto& route_info = route_infos[i];
+        if (!route_info) {
+            continue;
+        }
+        
+        // время складывается в прямом порядке рёбер, как у прямого поиска
+        std::reverse(route_info->edges.begin(), route_info->edges.end());
+        double time = 0;
+        for (const graph::EdgeId edge_id : route_info->edges) {
+            time += graph_->GetEdge(edge_id).weight;
+        }
+        result[target_indices[i]] = MakeRouteData(time, route_info->edges);
+    }
+    
+    return result;
+}
+
+std::vector<ReachableStop> TransportRouter::GetReachableStops(const Stop* from, double max_time) {
+    std::vector<ReachableStop> result;
+    
+    if (raptor_router_) {
+        for (const auto& [stop, time] : raptor_router_->BuildTimesWithin(from, max_time)) {
+            result.push_back(ReachableStop{stop, time});
+        }
+    } else if (!IsStopInGraph(from)) {
+        result.push_back(ReachableStop{from, 0});
+    } else {
+        std::call_once(reachability_built_, [this] {
+            SetReachabilityRouter();
+        });
+        
+        for (const auto& [vertex, time] : reachability_router_->BuildWeightsWithin(GetBusWaitingPeriod(from).start_bus_wait,
+                                                                                   max_time)) {
+            if (stop_by_vertex_[vertex]) {
+                result.push_back(ReachableStop{stop_by_vertex_[vertex], time});
+            }
+        }
+    }
+    
+    std::sort(result.begin(), result.end(), [](const ReachableStop& lhs, const ReachableStop& rhs) {
+        return lhs.time < rhs.time || (lhs.time == rhs.time && lhs.stop->name < rhs.stop->name);
+    });
+    
+    return result;
+}
+
+void TransportRouter::SetReachabilityRouter() {
+    if (!csr_graph_) {
+        FreezeGraph();
+    }
+    reachability_router_ = std::make_unique<graph::DijkstraRouter<double, graph::CsrGraph<double>>>(*csr_graph_);
+}
+
+void TransportRouter::SetStopByVertex() {
+    stop_by_vertex_.assign(graph_->GetVertexCount(), nullptr);
+    for (const Stop& stop : db_.GetStops()) {
+        if (IsStopInGraph(&stop)) {
+            stop_by_vertex_[GetBusWaitingPeriod(&stop).start_bus_wait] = &stop;
+        }
+    }
+}
+
+void TransportRouter::SetReverseRouter() {
+    reverse_csr_graph_ = std::make_unique<graph::CsrGraph<double>>(graph::CsrGraph<double>::Reversed(*graph_));
+    reverse_router_ = std::make_unique<graph::DijkstraRouter<double, graph::CsrGraph<double>>>(*reverse_csr_graph_);
+}
+
+void TransportRouter::SetParetoRouter() {
+    pareto_router_ = std::make_unique<RaptorRouter>(db_,
+                                                    GetBusesInService(),
+                                                    routing_settings_.bus_wait_time,
+                                                    routing_settings_.bus_velocity * METERS_IN_A_KILOMETER / MINUTES_PER_HOUR,
+                                                    routing_settings_.max_transfers,
+                                                    FindWalkPairs(),
+                                                    routing_settings_.walk_velocity * METERS_IN_A_KILOMETER / MINUTES_PER_HOUR);
+}
+
+void TransportRouter::AddBus(const Bus* bus) {
+    if (buses_in_service_.size() < db_.GetBuses().size()) {
+        buses_in_service_.resize(db_.GetBuses().size(), false);
+    }
+    if (buses_in_service_.at(bus->id)) {
+        throw std::invalid_argument("Bus is already in service");
+    }
+    buses_in_service_[bus->id] = true;
+    
+    std::vector<graph::EdgeId> improved_edges;
+    if (graph_) {
+        PrepareBusEdges();
+        improved_edges = AddNewStops(bus);
+        
+        const graph::VertexId first_vertex = graph_->GetVertexCount();
+        if (routing_settings_.graph_model == GraphModel::ROUTE_PATTERN) {
+            for (size_t i = 0; i < bus->stops.size(); ++i) {
+                graph_->AddVertex();
+            }
+        }
+        for (const auto& [edge, edge_data] : MakeBusEdges(bus, first_vertex)) {
+            improved_edges.push_back(graph_->GetEdgeCount());
+            bus_edges_[bus->id].push_back(graph_->GetEdgeCount());
+            AddEdge(edge, edge_data);
+        }
+    }
+    
+    UpdateRouter(improved_edges, {});
+}
+
+void TransportRouter::RemoveBus(const Bus* bus) {
+    if (bus->id >= buses_in_service_.size() || !buses_in_service_[bus->id]) {
+        throw std::invalid_argument("Bus is not in service");
+    }
+    buses_in_service_[bus->id] = false;
+    
+    std::vector<graph::EdgeId> worsened_edges;
+    if (graph_) {
+        PrepareBusEdges();
+        worsened_edges.swap(bus_edges_[bus->id]);
+        for (const graph::EdgeId edge_id : worsened_edges) {
+            graph_->RemoveEdge(edge_id);
+        }
+    }
+    
+    UpdateRouter({}, worsened_edges);
+}
+
+void TransportRouter::ReweightBus(const Bus* bus) {
+    if (bus->id >= buses_in_service_.size() || !buses_in_service_[bus->id]) {
+        throw std::invalid_argument("Bus is not in service");
+    }
+    
+    std::vector<graph::EdgeId> improved_edges;
+    std::vector<graph::EdgeId> worsened_edges;
+    if (graph_) {
+        PrepareBusEdges();
+        const std::vector<graph::EdgeId>& edge_ids = bus_edges_[bus->id];
+        
+        // в модели маршрутов первое ребро автобуса - посадка на первой остановке, оно ведёт в начало цепочки
+        const graph::VertexId first_vertex = !edge_ids.empty() && routing_settings_.graph_model == GraphModel::ROUTE_PATTERN
+                                             ? graph_->GetEdge(edge_ids.front()).to
+                                             : 0;
+        const BusEdges bus_edges = MakeBusEdges(bus, first_vertex);
+        if (bus_edges.size() != edge_ids.size()) {
+            throw std::logic_error("Bus stops have changed since the bus was added");
+        }
+        
+        for (size_t i = 0; i < edge_ids.size(); ++i) {
+            const double weight = graph_->GetEdge(edge_ids[i]).weight;
+            const double new_weight = bus_edges[i].first.weight;
+            if (new_weight < weight) {
+                improved_edges.push_back(edge_ids[i]);
+            } else if (new_weight > weight) {
+                worsened_edges.push_back(edge_ids[i]);
+            }
+            graph_->SetEdgeWeight(edge_ids[i], new_weight);
+            edges_[edge_ids[i]] = bus_edges[i].second;
+        }
+    }
+    
+    UpdateRouter(improved_edges, worsened_edges);
+}
+
+std::vector<graph::EdgeId> TransportRouter::AddNewStops(const Bus* bus) {
+    std::vector<graph::EdgeId> result;
+    
+    const size_t known_stop_count = bus_waiting_periods_.size();
+    bus_waiting_periods_.resize(db_.GetStops().size());
+    
+    // новых остановок немного, соседи ищутся перебором
+    if (routing_settings_.walk_radius > 0) {
+        for (size_t stop_id = known_stop_count; stop_id < db_.GetStops().size(); ++stop_id) {
+            const Stop& stop = db_.GetStops()[stop_id];
+            for (size_t other_id = 0; other_id < stop_id; ++other_id) {
+                const Stop& other = db_.GetStops()[other_id];
+                if (geo::ComputeDistance(stop.coord, other.coord) <= routing_settings_.walk_radius) {
+                    AddStopVertices(stop, result);
+                    AddStopVertices(other, result);
+                    result.push_back(graph_->GetEdgeCount());
+                    AddWalkEdge(stop, other);
+                    result.push_back(graph_->GetEdgeCount());
+                    AddWalkEdge(other, stop);
+                }
+            }
+        }
+    }
+    
+    for (const Stop* stop : bus->stops) {
+        AddStopVertices(*stop, result);
+    }
+    
+    return result;
+}
+
+void TransportRouter::AddStopVertices(const Stop& stop, std::vector<graph::EdgeId>& new_edges) {
+    if (IsStopInGraph(&stop)) {
+        return;
+    }
+    
+    const graph::VertexId start_bus_wait = graph_->AddVertex();
+    if (routing_settings_.graph_model == GraphModel::COLLAPSED) {
+        bus_waiting_periods_[stop.id] = BusWaitingPeriod{start_bus_wait, start_bus_wait};
+        return;
+    }
+    const graph::VertexId end_bus_wait = graph_->AddVertex();
+    bus_waiting_periods_[stop.id] = BusWaitingPeriod{start_bus_wait, end_bus_wait};
+    
+    new_edges.push_back(graph_->GetEdgeCount());
+    AddEdge(graph::Edge<double>{start_bus_wait, end_bus_wait, routing_settings_.bus_wait_time},
+            StopEdge{static_cast<uint32_t>(stop.id), routing_settings_.bus_wait_time});
+}
+
+void TransportRouter::PrepareBusEdges() {
+    if (bus_edges_.empty()) {
+        bus_edges_.resize(buses_in_service_.size());
+        for (graph::EdgeId edge_id = 0; edge_id < edges_.size(); ++edge_id) {
+            const BusEdge* bus_edge = std::get_if<BusEdge>(&edges_[edge_id]);
+            if (bus_edge && !graph_->IsEdgeRemoved(edge_id)) {
+                bus_edges_[bus_edge->bus_id].push_back(edge_id);
+            }
+        }
+    }
+    bus_edges_.resize(buses_in_service_.size());
+}
+
+void TransportRouter::UpdateRouter(const std::vector<graph::EdgeId>& improved_edges,
+                                   const std::vector<graph::EdgeId>& worsened_edges) {
+    if (csr_graph_) {
+        FreezeGraph();
+    }
+    if (graph_) {
+        SetComponents();
+        SetStopByVertex();
+    }
+    
+    switch (routing_settings_.router_type) {
+        case RouterType::ALL_PAIRS:
+            static_cast<graph::Router<double>&>(*router_).UpdateEdges(improved_edges,
+                                                                      worsened_edges,
+                                                                      std::thread::hardware_concurrency());
+            break;
+        case RouterType::CONTRACTION_HIERARCHY:
+            // порядок сжатия зависит от всего графа, иерархия строится заново
+            router_ = std::make_unique<graph::ContractionHierarchy<double>>(*graph_);
+            break;
+        case RouterType::HUB_LABELS:
+            // метки зависят от порядка хабов по всему графу, строятся заново
+            router_ = std::make_unique<graph::HubLabels<double>>(*graph_);
+            break;
+        case RouterType::DIJKSTRA:
+        case RouterType::ASTAR:
+        case RouterType::ALT:
+        case RouterType::RAPTOR:
+            // предвычислений нет или они линейны по размеру сети
+            SetRouter();
+            break;
+    }
+    
+    if (reachability_router_) {
+        SetReachabilityRouter();
+    }
+    if (pareto_router_) {
+        SetParetoRouter();
+    }
+    if (reverse_router_) {
+        SetReverseRouter();
+    }
+    if (route_cache_) {
+        route_cache_->Clear();
+    }
+}
+
+std::vector<const Bus*> TransportRouter::GetBusesInService() const {
+    std::vector<const Bus*> result;
+    
+    for (const Bus& bus : db_.GetBuses()) {
+        if (bus.id < buses_in_service_.size() && buses_in_service_[bus.id]) {
+            result.push_back(&bus);
+        }
+    }
+    
+    return result;
+}
+
+BusWaitingPeriod TransportRouter::GetBusWaitingPeriod(const Stop* stop) const {
+    return bus_waiting_periods_.at(stop->id);
+}
+
+bool TransportRouter::IsStopInGraph(const Stop* stop) const {
+    return stop->id < bus_waiting_periods_.size() && bus_waiting_periods_[stop->id].start_bus_wait != NO_VERTEX;
+}
+
+double TransportRouter::GetGeoLowerBound(size_t from, size_t to) const {
+    const double geo_distance = geo::ComputeDistance(vertex_coordinates_[from], vertex_coordinates_[to]);
+    
+    return geo_distance > 0 ? geo_distance * minutes_per_geo_meter_ : 0;
+}
+
+const RoutingSettings& TransportRouter::GetRoutingSettings() const {
+    return routing_settings_;
+}
+
+bool TransportRouter::HasGraph() const {
+    return graph_ != nullptr;
+}
+
+const graph::DirectedWeightedGraph<double>& TransportRouter::GetGraph() const {
+    return *graph_;
+}
+
+const graph::RouterBase<double>& TransportRouter::GetRouter() const {
+    return *router_;
+}
+
+const graph::ConnectivityComponents& TransportRouter::GetComponents() const {
+    return *components_;
+}
+
+const std::vector<EdgeData>& TransportRouter::GetEdges() const {
+    return edges_;
+}
+
+const std::vector<BusWaitingPeriod>& TransportRouter::GetBusWaitingPeriods() const {
+    return bus_waiting_periods_;
+}
+
+LazyTransportRouter::LazyTransportRouter(Factory factory)
+: factory_(std::move(factory))
+{
+}
+
+TransportRouter& LazyTransportRouter::Get() {
+    std::call_once(built_, [this] {
+        router_ = factory_();
+        factory_ = nullptr;
+    });
+    
+    return *router_;
+}
+
+bool LazyTransportRouter::IsBuilt() const {
+    return router_ != nullptr;
 }
 
 } //end namespace router
@@ -1,83 +1,305 @@
 #pragma once
 
 #include "router.h"
+#include "dijkstra_router.h"
+#include "contraction_hierarchy.h"
+#include "hub_labels.h"
+#include "fixed_point.h"
+#include "connectivity.h"
+#include "landmarks.h"
+#include "raptor_router.h"
 #include "domain.h"
+#include "json.h"
+#include "sharded_lru_cache.h"
 #include "transport_catalogue.h"
 
+#include <functional>
+#include <limits>
 #include <unordered_map>
 #include <memory>
+#include <mutex>
 #include <variant>
 #include <deque>
 #include <optional>
+#include <utility>
 
 namespace transport_catalogue {
 namespace router {
 
 static const int METERS_IN_A_KILOMETER = 1000;
 static const int MINUTES_PER_HOUR = 60;
+static const int MILLISECONDS_PER_MINUTE = 60000;
+
+// Движок поиска маршрутов
+enum class RouterType {
+    ALL_PAIRS,            // предвычисление всех пар вершин (Флойд-Уоршелл)
+    DIJKSTRA,             // поиск Дейкстрой в момент запроса
+    CONTRACTION_HIERARCHY, // иерархия сжатия, строится в make_base
+    ASTAR,                 // A* с оценкой по расстоянию между остановками на сфере
+    ALT,                   // A* с ориентирами, оценка не хуже ASTAR
+    RAPTOR,                // поиск по раундам без графа, см. RaptorRouter
+    HUB_LABELS             // метки хабов, строятся в make_base, запрос - слияние двух меток
+};
+
+// Как автобусы представлены в графе
+enum class GraphModel {
+    COMPLETE,       // ребро от каждой остановки автобуса до каждой следующей
+    ROUTE_PATTERN,  // цепочка вершин по остановкам автобуса: посадка, перегоны, высадка
+    COLLAPSED       // рёбра как в COMPLETE, но у остановки одна вершина, а ожидание входит в вес рёбер автобуса
+};
 
 struct RoutingSettings {
     double bus_wait_time = 4;
     double bus_velocity = 30;
+    RouterType router_type = RouterType::ALL_PAIRS;
+    GraphModel graph_model = GraphModel::COMPLETE;
+    // для RAPTOR и маршрутов по Парето: наибольшее число пересадок в маршруте
+    std::optional<int> max_transfers;
+    // число маршрутов в кэше ответов, 0 - без кэша
+    size_t route_cache_capacity = 4096;
+    // только для DIJKSTRA: поиск по копии графа с временем в целых миллисекундах
+    bool fixed_point_weights = false;
+    // пешие переходы между остановками не дальше walk_radius метров по прямой, 0 - без них;
+    // скорость пешехода в км/ч
+    double walk_radius = 0;
+    double walk_velocity = 5;
 };
 
+// Описания рёбер ссылаются на остановку и автобус по их id в справочнике
 struct StopEdge {
-    std::string_view name;
+    uint32_t stop_id = 0;
     double time = 0;
 };
 
 struct BusEdge {
-    std::string_view name;
+    uint32_t bus_id = 0;
     double time = 0;
     int number_of_stops = 0;
 };
 
+// Пеший переход от остановки к остановке
+struct WalkEdge {
+    uint32_t from_stop_id = 0;
+    uint32_t to_stop_id = 0;
+    double time = 0;
+};
+
+// вершины остановки, через которую не идёт ни один автобус и нет пеших переходов:
+// в графе таких остановок нет
+inline constexpr size_t NO_VERTEX = std::numeric_limits<size_t>::max();
+
+// в модели COLLAPSED обе вершины остановки совпадают
 struct BusWaitingPeriod {
-  size_t start_bus_wait;
-  size_t end_bus_wait;
+  size_t start_bus_wait = NO_VERTEX;
+  size_t end_bus_wait = NO_VERTEX;
 };
 
+using EdgeData = std::variant<StopEdge, BusEdge, WalkEdge>;
+
 struct RouteData {
     double time = 0;
-    std::vector<std::variant<StopEdge, BusEdge>> edges;
+    std::vector<EdgeData> edges;
+};
+
+// Ответ на запрос маршрута в кэше: маршрут и уже собранный JSON-массив items
+struct CachedRoute {
+    std::optional<RouteData> route;
+    json::Node items;
+};
+
+// Остановка, достижимая в пределах заданного времени
+struct ReachableStop {
+    const Stop* stop = nullptr;
+    double time = 0;
 };
 
+using RouteItemsBuilder = std::function<json::Node(const RouteData& route)>;
+
+struct StopPairHasher {
+    size_t operator()(const std::pair<const Stop*, const Stop*>& stops) const {
+        return hasher_(stops.first) * 37 + hasher_(stops.second);
+    }
+    
+private:
+    std::hash<const Stop*> hasher_;
+};
+
+using RouteCache = concurrency::ShardedLruCache<std::pair<const Stop*, const Stop*>,
+                                                std::shared_ptr<const CachedRoute>,
+                                                StopPairHasher>;
+
 class TransportRouter {
 public:
     TransportRouter() = delete;
     TransportRouter(TransportCatalogue& db, RoutingSettings& routing_settings);
+    // Восстанавливает роутер из базы: граф и данные рёбер не перестраиваются,
+    // router == nullptr - движок строится заново по готовому графу, components == nullptr -
+    // компоненты считаются заново. edges - по индексу id ребра, bus_waiting_periods - по id остановки
+    TransportRouter(TransportCatalogue& db,
+                    RoutingSettings& routing_settings,
+                    std::unique_ptr<graph::DirectedWeightedGraph<double>> graph,
+                    std::unique_ptr<graph::RouterBase<double>> router,
+                    std::vector<EdgeData> edges,
+                    std::vector<BusWaitingPeriod> bus_waiting_periods,
+                    std::unique_ptr<graph::ConnectivityComponents> components = nullptr);
     
-    void SetStops();
+    // Нумерует вершины остановок, которые входят в граф, и возвращает их число
+    size_t SetStops(const std::vector<std::pair<size_t, size_t>>& walk_pairs);
     
     void SetGraph();
     
     void AddEdgeToStop();
     void AddEdgeToBus();
+    void AddRoutePatterns(graph::VertexId first_vertex);
+    // Пары остановок в пределах walk_radius, ищутся по сетке координат; пусто без пеших переходов
+    std::vector<std::pair<size_t, size_t>> FindWalkPairs() const;
+    // Пешие переходы между остановками каждой пары в обе стороны
+    void AddWalkEdges(const std::vector<std::pair<size_t, size_t>>& walk_pairs);
+    
+    void FreezeGraph();
+    void SetComponents();
+    void SetGeoLowerBound();
+    void SetRouter();
+    void SetRouteCache();
     
-    const graph::Edge<double> СreateEdgeToBus(Stop* start_stop, Stop* end_stop, const double distance);
+    const graph::Edge<double> СreateEdgeToBus(Stop* start_stop, Stop* end_stop, const double distance) const;
+    
+    // Изменения маршрутной сети без полной перестройки: автобус и его остановки уже должны
+    // быть в справочнике. AddBus включает автобус в поиск маршрутов, RemoveBus исключает,
+    // ReweightBus пересчитывает время его перегонов по текущим расстояниям справочника.
+    // Маршруты, которых изменение не касается, не пересчитываются; кэш ответов очищается.
+    // Вызывать не одновременно с запросами маршрутов
+    void AddBus(const Bus* bus);
+    void RemoveBus(const Bus* bus);
+    void ReweightBus(const Bus* bus);
     
     std::optional<RouteData> GetRouteInformation(size_t from, size_t to);
-    BusWaitingPeriod GetBusWaitingPeriod(Stop* stop);
+    std::optional<RouteData> GetRouteInformation(const Stop* from, const Stop* to);
+    // Маршрут из кэша; при промахе строится заново, а build_items собирает для кэша его items
+    std::shared_ptr<const CachedRoute> GetCachedRoute(const Stop* from, const Stop* to, const RouteItemsBuilder& build_items);
+    RouteCache::Statistics GetRouteCacheStatistics() const;
+    // Маршруты, оптимальные по Парето по времени и числу поездок, по возрастанию числа поездок:
+    // самый быстрый маршрут и самые быстрые среди маршрутов с меньшим числом пересадок.
+    // Ищутся RAPTOR при любом движке маршрутов
+    std::vector<RouteData> GetParetoRoutes(const Stop* from, const Stop* to);
+    // Время в пути от from до каждой из остановок to одним поиском, без восстановления маршрутов.
+    // nullptr вместо остановки - неизвестная остановка, маршрута до неё или из неё нет
+    std::vector<std::optional<double>> GetTravelTimes(const Stop* from, const std::vector<const Stop*>& to);
+    // Маршруты до остановки to из каждой из остановок from, nullopt - маршрута нет или вместо
+    // остановки nullptr. Все маршруты находит один поиск назад от to по развёрнутому графу;
+    // рёбра маршрутов - в прямом порядке
+    std::vector<std::optional<RouteData>> GetRoutesTo(const std::vector<const Stop*>& from, const Stop* to);
+    // Остановки, до которых можно добраться из from не дольше max_time, по возрастанию времени.
+    // Поиск ограничен по времени и не зависит от выбранного движка маршрутов
+    std::vector<ReachableStop> GetReachableStops(const Stop* from, double max_time);
+    BusWaitingPeriod GetBusWaitingPeriod(const Stop* stop) const;
+    bool IsStopInGraph(const Stop* stop) const;
+    // Нижняя оценка времени в пути между вершинами графа по координатам остановок
+    double GetGeoLowerBound(size_t from, size_t to) const;
     
-    template <typename Iterator>
-    void FillBusToEdge(Iterator first, Iterator last, const Bus* bus);
+    const RoutingSettings& GetRoutingSettings() const;
+    // RAPTOR отвечает на запросы без графа
+    bool HasGraph() const;
+    const graph::DirectedWeightedGraph<double>& GetGraph() const;
+    const graph::RouterBase<double>& GetRouter() const;
+    const graph::ConnectivityComponents& GetComponents() const;
+    const std::vector<EdgeData>& GetEdges() const;
+    const std::vector<BusWaitingPeriod>& GetBusWaitingPeriods() const;
     
 private:
+    using BusEdges = std::vector<std::pair<graph::Edge<double>, BusEdge>>;
+    
+    // добавляет ребро в граф и его описание под тем же id
+    void AddEdge(const graph::Edge<double>& edge, EdgeData edge_data);
+    void AddWalkEdge(const Stop& from, const Stop& to);
+    
+    template <typename Iterator>
+    void FillBusToEdge(Iterator first, Iterator last, const Bus* bus, BusEdges& result) const;
+    // Рёбра автобуса в модели графа из настроек; first_vertex - начало его цепочки в модели маршрутов
+    BusEdges MakeBusEdges(const Bus* bus, graph::VertexId first_vertex) const;
+    
+    // Вершины, рёбра ожидания и пешие переходы остановок, которые появились в графе после
+    // его построения: остановок автобуса bus и новых остановок справочника с соседями
+    std::vector<graph::EdgeId> AddNewStops(const Bus* bus);
+    // Вершины и ребро ожидания остановки, если её ещё нет в графе
+    void AddStopVertices(const Stop& stop, std::vector<graph::EdgeId>& new_edges);
+    // Собирает рёбра каждого автобуса при первом изменении сети
+    void PrepareBusEdges();
+    // Приводит движок, кэш и поиск достижимых остановок в соответствие с изменённым графом
+    void UpdateRouter(const std::vector<graph::EdgeId>& improved_edges, const std::vector<graph::EdgeId>& worsened_edges);
+    std::vector<const Bus*> GetBusesInService() const;
+    
+    void SetStopByVertex();
+    void SetReachabilityRouter();
+    void SetParetoRouter();
+    void SetReverseRouter();
+    RouteData MakeRouteData(const RaptorRouter::Journey& journey) const;
+    // Поездка по автобусу из нескольких рёбер подряд собирается в одно описание
+    RouteData MakeRouteData(double time, const std::vector<graph::EdgeId>& edge_ids) const;
+    
     // параметры
     TransportCatalogue& db_;
     
     RoutingSettings routing_settings_;
     
     std::unique_ptr<graph::DirectedWeightedGraph<double>> graph_;
-    std::unique_ptr<graph::Router<double>> router_;
+    // CSR-копия graph_ для движков, обходящих граф во время запроса
+    std::unique_ptr<graph::CsrGraph<double>> csr_graph_;
+    std::unique_ptr<graph::RouterBase<double>> router_;
+    // компоненты связности graph_: пары без пути отсекаются до запроса к движку
+    std::unique_ptr<graph::ConnectivityComponents> components_;
+    
+    // для эвристик A*: координаты остановки каждой вершины и минуты на метр по прямой
+    std::vector<geo::Coordinates> vertex_coordinates_;
+    double minutes_per_geo_meter_ = 0;
+    std::unique_ptr<graph::Landmarks<double>> landmarks_;
+    
+    std::unique_ptr<RaptorRouter> raptor_router_;
+    // RAPTOR для GetParetoRoutes при другом движке, строится при первом запросе
+    std::once_flag pareto_built_;
+    std::unique_ptr<RaptorRouter> pareto_router_;
+    
+    // ограниченный поиск для GetReachableStops, строится при первом запросе
+    std::once_flag reachability_built_;
+    std::unique_ptr<graph::DijkstraRouter<double, graph::CsrGraph<double>>> reachability_router_;
     
-    std::unordered_map<size_t, std::variant<StopEdge, BusEdge>> map_id_to_edge_;
-    std::unordered_map<const Stop*, BusWaitingPeriod> map_stop_to_bus_period_;
+    // развёрнутая CSR-копия graph_ и поиск по ней для GetRoutesTo, строятся при первом запросе
+    std::once_flag reverse_built_;
+    std::unique_ptr<graph::CsrGraph<double>> reverse_csr_graph_;
+    std::unique_ptr<graph::DijkstraRouter<double, graph::CsrGraph<double>>> reverse_router_;
     
+    std::unique_ptr<RouteCache> route_cache_;
+    
+    std::vector<EdgeData> edges_;
+    std::vector<BusWaitingPeriod> bus_waiting_periods_;
+    // остановка по вершине прибытия, nullptr для прочих вершин
+    std::vector<const Stop*> stop_by_vertex_;
+    
+    // по id автобуса: участвует ли он в поиске маршрутов и id его рёбер в графе
+    std::vector<bool> buses_in_service_;
+    std::vector<std::vector<graph::EdgeId>> bus_edges_;
+    
+};
+
+// Роутер, который строится при первом обращении: запросам к справочнику
+// и карте не нужно ждать построения графа и предвычислений
+class LazyTransportRouter {
+public:
+    using Factory = std::function<std::unique_ptr<TransportRouter>()>;
+    
+    explicit LazyTransportRouter(Factory factory);
+    
+    TransportRouter& Get();
+    bool IsBuilt() const;
+    
+private:
+    Factory factory_;
+    std::unique_ptr<TransportRouter> router_;
+    std::once_flag built_;
 };
 
 template <typename Iterator>
-void TransportRouter::FillBusToEdge(Iterator first, Iterator last, const Bus* bus) {
+void TransportRouter::FillBusToEdge(Iterator first, Iterator last, const Bus* bus, BusEdges& result) const {
     
     int distance = 0;
     int number_of_stops = 0;
@@ -88,8 +310,8 @@ void TransportRouter::FillBusToEdge(Iterator first, Iterator last, const Bus* bu
             distance += db_.GetDistanceBetweenStops(*prev(it), *it);
             ++number_of_stops;
             
-            size_t edge_id = graph_->AddEdge(СreateEdgeToBus(*first, *it, distance));
-            map_id_to_edge_[edge_id] = BusEdge{bus->name, graph_->GetEdge(edge_id).weight, number_of_stops};
+            const graph::Edge<double> edge = СreateEdgeToBus(*first, *it, distance);
+            result.emplace_back(edge, BusEdge{static_cast<uint32_t>(bus->id), edge.weight, number_of_stops});
         }
         
         distance = 0;
@@ -0,0 +1,235 @@
+#include "transport_catalogue.h"
+#include "transport_router.h"
+
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std::literals;
+
+namespace test {
+
+using transport_catalogue::Bus;
+using transport_catalogue::Stop;
+using transport_catalogue::TransportCatalogue;
+namespace router = transport_catalogue::router;
+
+// Описание города, по которому справочник заполняется заново на каждом шаге проверки
+struct City {
+    struct BusRoute {
+        std::string name;
+        std::vector<size_t> stops;
+        bool is_roundtrip = false;
+    };
+
+    std::vector<geo::Coordinates> stops;
+    // расстояние от первой остановки до второй
+    std::vector<std::pair<std::pair<size_t, size_t>, double>> distances;
+    std::vector<BusRoute> buses;
+};
+
+std::string GetStopName(size_t index) {
+    return "Stop"s + std::to_string(index);
+}
+
+City MakeCity(std::mt19937& generator) {
+    static constexpr size_t STOP_COUNT = 40;
+    static constexpr size_t BUS_COUNT = 12;
+
+    City result;
+    std::uniform_real_distribution<double> shift(0, 0.05);
+    for (size_t i = 0; i < STOP_COUNT; ++i) {
+        result.stops.push_back(geo::Coordinates{55.7 + shift(generator), 37.6 + shift(generator)});
+    }
+
+    std::uniform_int_distribution<size_t> stop_distribution(0, STOP_COUNT - 1);
+    std::uniform_int_distribution<size_t> length_distribution(2, 7);
+    std::uniform_real_distribution<double> detour(1.1, 1.6);
+    for (size_t i = 0; i < BUS_COUNT; ++i) {
+        City::BusRoute bus{"Bus"s + std::to_string(i), {}, i % 2 == 0};
+        const size_t length = length_distribution(generator);
+        while (bus.stops.size() < length) {
+            const size_t stop = stop_distribution(generator);
+            if (bus.stops.empty() || bus.stops.back() != stop) {
+                bus.stops.push_back(stop);
+            }
+        }
+        if (bus.is_roundtrip) {
+            bus.stops.push_back(bus.stops.front());
+        }
+
+        for (size_t j = 1; j < bus.stops.size(); ++j) {
+            const size_t from = bus.stops[j - 1];
+            const size_t to = bus.stops[j];
+            const double distance = geo::ComputeDistance(result.stops[from], result.stops[to]);
+            result.distances.push_back({{from, to}, std::round(distance * detour(generator)) + 1});
+            result.distances.push_back({{to, from}, std::round(distance * detour(generator)) + 1});
+        }
+        result.buses.push_back(std::move(bus));
+    }
+
+    return result;
+}
+
+// Автобус так же, как его собирает json_reader: у некольцевого обратный путь дописан в конец
+Bus MakeBus(const City::BusRoute& bus_route, TransportCatalogue& catalogue) {
+    Bus result;
+    result.name = bus_route.name;
+    result.is_roundtrip = bus_route.is_roundtrip;
+    for (const size_t stop : bus_route.stops) {
+        result.stops.push_back(catalogue.GetStop(GetStopName(stop)));
+    }
+    if (!result.is_roundtrip) {
+        for (size_t i = bus_route.stops.size() - 1; i > 0; --i) {
+            result.stops.push_back(result.stops[i - 1]);
+        }
+    }
+    return result;
+}
+
+void FillCatalogue(const City& city, TransportCatalogue& catalogue) {
+    for (size_t i = 0; i < city.stops.size(); ++i) {
+        Stop stop;
+        stop.name = GetStopName(i);
+        stop.coord = city.stops[i];
+        catalogue.AddStop(std::move(stop));
+    }
+    for (const auto& [stops, distance] : city.distances) {
+        catalogue.SetDistance(catalogue.GetStop(GetStopName(stops.first)), catalogue.GetStop(GetStopName(stops.second)), distance);
+    }
+    for (const City::BusRoute& bus_route : city.buses) {
+        catalogue.AddBus(MakeBus(bus_route, catalogue));
+    }
+}
+
+// Число пар остановок, для которых роутер после изменений отвечает не так,
+// как роутер, построенный заново по тому же городу
+size_t CountMismatches(router::TransportRouter& updated, TransportCatalogue& updated_catalogue, const City& city,
+                       const router::RoutingSettings& routing_settings, const std::string& step) {
+    TransportCatalogue catalogue;
+    FillCatalogue(city, catalogue);
+    router::RoutingSettings settings = routing_settings;
+    router::TransportRouter rebuilt(catalogue, settings);
+
+    size_t result = 0;
+    for (size_t i = 0; i < city.stops.size(); ++i) {
+        for (size_t j = 0; j < city.stops.size(); ++j) {
+            const auto expected = rebuilt.GetRouteInformation(catalogue.GetStop(GetStopName(i)), catalogue.GetStop(GetStopName(j)));
+            const auto actual = updated.GetRouteInformation(updated_catalogue.GetStop(GetStopName(i)),
+                                                            updated_catalogue.GetStop(GetStopName(j)));
+
+            if (expected.has_value() != actual.has_value()
+                || (expected && std::abs(expected->time - actual->time) > 1e-9 * std::max(1.0, expected->time))) {
+                if (++result <= 3) {
+                    std::cerr << step << ": "sv << GetStopName(i) << " -> "sv << GetStopName(j) << ": expected "sv
+                              << (expected ? std::to_string(expected->time) : "no route"s) << ", got "sv
+                              << (actual ? std::to_string(actual->time) : "no route"s) << "\n"sv;
+                }
+            }
+        }
+    }
+
+    return result;
+}
+
+// Удаление автобуса, новые расстояния на его перегонах и новый автобус через новую остановку:
+// после каждого изменения время всех маршрутов совпадает с роутером, построенным заново
+size_t TestIncrementalUpdates(router::RouterType router_type, router::GraphModel graph_model) {
+    std::mt19937 generator(42);
+    City city = MakeCity(generator);
+
+    router::RoutingSettings routing_settings;
+    routing_settings.bus_wait_time = 3;
+    routing_settings.bus_velocity = 30;
+    routing_settings.router_type = router_type;
+    routing_settings.graph_model = graph_model;
+
+    TransportCatalogue catalogue;
+    FillCatalogue(city, catalogue);
+    router::TransportRouter transport_router(catalogue, routing_settings);
+
+    size_t result = CountMismatches(transport_router, catalogue, city, routing_settings, "build"s);
+
+    // RemoveBus
+    transport_router.RemoveBus(catalogue.GetBus(city.buses[3].name));
+    City removed_city = city;
+    removed_city.buses.erase(removed_city.buses.begin() + 3);
+    result += CountMismatches(transport_router, catalogue, removed_city, routing_settings, "remove"s);
+
+    // ReweightBus: один перегон короче, другой длиннее. Пересчитываются все автобусы,
+    // которые проходят между этими остановками
+    const City::BusRoute& reweighted = city.buses[5];
+    const std::vector<std::pair<std::pair<size_t, size_t>, double>> new_distances{
+        {{reweighted.stops[0], reweighted.stops[1]}, 50},
+        {{reweighted.stops[1], reweighted.stops[0]}, 20000},
+    };
+    for (const auto& [stops, distance] : new_distances) {
+        catalogue.SetDistance(catalogue.GetStop(GetStopName(stops.first)), catalogue.GetStop(GetStopName(stops.second)), distance);
+        removed_city.distances.push_back({stops, distance});
+    }
+    for (const City::BusRoute& bus_route : removed_city.buses) {
+        const Bus* bus = catalogue.GetBus(bus_route.name);
+        for (size_t i = 1; i < bus->stops.size(); ++i) {
+            const size_t from = bus->stops[i - 1]->id;
+            const size_t to = bus->stops[i]->id;
+            if ((from == reweighted.stops[0] && to == reweighted.stops[1]) || (from == reweighted.stops[1] && to == reweighted.stops[0])) {
+                transport_router.ReweightBus(bus);
+                break;
+            }
+        }
+    }
+    result += CountMismatches(transport_router, catalogue, removed_city, routing_settings, "reweight"s);
+
+    // AddBus с остановкой, которой не было при построении графа
+    const size_t new_stop = removed_city.stops.size();
+    removed_city.stops.push_back(geo::Coordinates{55.72, 37.62});
+    Stop stop;
+    stop.name = GetStopName(new_stop);
+    stop.coord = removed_city.stops.back();
+    catalogue.AddStop(std::move(stop));
+
+    const City::BusRoute new_bus{"NewBus"s, {new_stop, 0, 7, 13}, false};
+    for (size_t i = 1; i < new_bus.stops.size(); ++i) {
+        const std::pair<size_t, size_t> stops{new_bus.stops[i - 1], new_bus.stops[i]};
+        catalogue.SetDistance(catalogue.GetStop(GetStopName(stops.first)), catalogue.GetStop(GetStopName(stops.second)), 700);
+        removed_city.distances.push_back({stops, 700});
+    }
+    removed_city.buses.push_back(new_bus);
+    catalogue.AddBus(MakeBus(new_bus, catalogue));
+    transport_router.AddBus(catalogue.GetBus(new_bus.name));
+    result += CountMismatches(transport_router, catalogue, removed_city, routing_settings, "add"s);
+
+    return result;
+}
+
+} //end namespace test
+
+int main() {
+    namespace router = transport_catalogue::router;
+
+    const std::vector<std::pair<router::RouterType, std::string>> router_types{
+        {router::RouterType::ALL_PAIRS, "all_pairs"s},
+        {router::RouterType::DIJKSTRA, "dijkstra"s},
+    };
+    const std::vector<std::pair<router::GraphModel, std::string>> graph_models{
+        {router::GraphModel::COMPLETE, "complete"s},
+        {router::GraphModel::ROUTE_PATTERN, "route_pattern"s},
+        {router::GraphModel::COLLAPSED, "collapsed"s},
+    };
+
+    size_t failed_count = 0;
+    for (const auto& [router_type, router_name] : router_types) {
+        for (const auto& [graph_model, model_name] : graph_models) {
+            const size_t mismatches = test::TestIncrementalUpdates(router_type, graph_model);
+            std::cout << router_name << ' ' << model_name << ": "sv << (mismatches == 0 ? "OK"s : std::to_string(mismatches) + " mismatches"s)
+                      << std::endl;
+            failed_count += mismatches != 0 ? 1 : 0;
+        }
+    }
+
+    return failed_count == 0 ? 0 : 1;
+}